@@ -1,4 +1,5 @@
 from _uepy import *
+from _uepy import _MakeForward
 
 from importlib import reload
 import sys, shlex, json, time, weakref, inspect, os
@@ -135,20 +136,22 @@ def Callers():
         ret.append('%s:%s:%d' % (os.path.basename(frame.filename), frame.function, frame.lineno))
     return ' <- '.join(ret)
 
-class Event:
+class Event(EventBase):
     '''Utility class for firing events locally among objects. Convention is for objects to declare a public event member variable that
     other objects access directly to add/remove listener callbacks. User Add/Remove to register/unregister a function to be called when
     the event owner calls event.Fire. The signature of the event is up to the owner and supports args and kwargs. Callbacks are weak
     referenced and it is not required to Remove a registered callback, but it must be owned by an object (the callback function object
-    must be a method bound to an object).'''
+    must be a method bound to an object).
+    The listener list and Fire live in C++ (EventBase), so firing doesn't run any Python code of its own. Each event also keeps
+    fireCount and fireSeconds (total time spent in Fire, callbacks included) for finding hot events; see ResetStats.'''
     DEBUG = False # when True, set self.source in __init__
     def __init__(self):
+        super().__init__()
         if Event.DEBUG:
             self.source = Caller() # super helpful for debugging
-        self.callbacks = [] # list of (owner, cb method)
 
     def Add(self, method):
-        self.callbacks.append(weakref.WeakMethod(method))
+        self._Add(method)
 
         # also make the owning object aware of what methods have been bound on it
         events = Event.GetBoundEventsListFor(method=method)
@@ -162,56 +165,9 @@ class Event:
                 events.pop(i)
                 break
 
-        for i, ref in enumerate(self.callbacks):
-            if ref() == method:
-                self.callbacks.pop(i)
-                return
-
-        if not missingOk:
+        if not self._Remove(method) and not missingOk:
             log('ERROR: failed to remove', method)
 
-    def RemoveOn(self, owner):
-        '''Removes any callbacks bound to the given object'''
-        keep = []
-        for ref in self.callbacks:
-            method = ref()
-            if method:
-                methOwner = getattr(method, '__self__', None)
-                if methOwner and methOwner == owner:
-                    continue
-                keep.append(ref)
-            # note that we're tossing any cleaned up weakrefs here by not adding back in refs that returned None for ref()
-        self.callbacks = keep
-
-    def RemoveAll(self):
-        self.callbacks = []
-
-    def Fire(self, *args, **kwargs):
-        '''Called by the owner to emit an event'''
-        world = GetWorld()
-        if not world or not world.IsValid() or world.bIsTearingDown:
-            return
-        if not IsInGameThread() and not IsInSlateThread():
-            log('ERROR: Event', self, 'Firing from wrong thread', Caller(), Caller(3), Caller(4), Caller(5), Caller(6), Caller(7), Caller(8), Caller(9), IsInGameThread(), IsInSlateThread())
-        for methodRef in self.callbacks[:]:
-            cb = methodRef()
-            if not cb:
-                self.callbacks.remove(methodRef)
-            else:
-                # Special case: if the owner of the callback is a Python wrapper for an engine object, it's possible that the
-                # underlying engine object is no longer valid, but the engine hasn't run GC yet, so the Python object still exists,
-                # so we need to detect that scenario and not call the callback.
-                engineObj = getattr(cb.__self__, 'engineObj', None)
-                if engineObj and not engineObj.IsValid():
-                    log('WARNING: skipping callback to', cb.__self__, cb, 'because engine obj is no longer valid')
-                    self.callbacks.remove(methodRef)
-                    continue
-
-                try:
-                    cb(*args, **kwargs)
-                except:
-                    logTB()
-
     @staticmethod
     def GetBoundEventsListFor(*, method=None, owner=None):
         '''helper to retrieve the list attached to the object owning the given method object that is used to hold weakrefs
@@ -340,6 +296,15 @@ class PyGlueMetaclass(NRTrackerMetaclass):
                         logTB()
                         log('Python class %s declares class default "%s" but setting the property failed' % (name, k))
 
+        # Classes can set forwardAllEngineMethods = True to get a forward (see FORWARDS) for every method of their C++ glue
+        # class that they don't already define
+        if dct.get('forwardAllEngineMethods'):
+            cppClass = getattr(glueclasses, name[:-6] + '_CGLUE', None) if isGlueClass else newPyClass.cppGlueClass
+            if cppClass is None:
+                log('WARNING: class %s wants forwardAllEngineMethods but has no C++ glue class' % name)
+            else:
+                FORWARD_ALL(newPyClass, cppClass)
+
         return newPyClass
 
     def __call__(cls, engineObj, *args, **kwargs):
@@ -370,6 +335,33 @@ def CPROPS(cls, *propNames):
             setattr(cls, name, property(_get, _set))
         setup(_name) # create a closure so we don't lose the name
 
+def FORWARDS(cls, *methodNames, returns=True):
+    '''For each name, makes cls.<name> a method that forwards straight to the engine object's method of the same name, i.e.
+        def <name>(self, *args, **kwargs): return self.engineObj.<name>(*args, **kwargs)
+    so the trivial one-line wrappers don't have to be written out by hand. If returns is False, the forwarded methods
+    return None instead of whatever the engine method returns (i.e. they act like "def <name>(...): self.engineObj...").
+    The forwarders are native (see PyForward.h), so a call doesn't run any Python code of its own: it costs a couple of
+    attribute lookups on top of calling self.engineObj.<name> directly, which is less than a handwritten wrapper. They
+    otherwise behave like handwritten methods: inst.<name> is a bound method whose __self__ is the Python instance (so it
+    works with Event.Add, Event.UnbindOn, etc.), cls.<name>(inst, ...) works, and subclasses and instances can override
+    them.'''
+    for name in methodNames:
+        setattr(cls, name, _MakeForward(name, returns))
+
+def FORWARD_ALL(cls, cppClass):
+    '''Forwards (see FORWARDS) every public method of the given pybind class that cls doesn't already have. Returns the
+    names that were forwarded.'''
+    names = []
+    for name in dir(cppClass):
+        if name.startswith('_') or name in ('StaticClass', 'Cast') or hasattr(cls, name):
+            continue
+        v = inspect.getattr_static(cppClass, name)
+        if isinstance(v, (property, staticmethod, classmethod)) or not callable(v):
+            continue # properties can be exposed via CPROPS instead
+        names.append(name)
+    FORWARDS(cls, *names)
+    return names
+
 def BPPROPS(cls, *propNames):
     '''Creates Python read/write properties for BP (reflection system) properties'''
     for _name in propNames:
@@ -420,6 +412,14 @@ class AActor_PGLUE(metaclass=PyGlueMetaclass):
         rot = FRotator(0,0,0),
     )
 
+    # Set to the name of a SpatialIndex (see GetSpatialIndex) to have instances automatically join it on BeginPlay
+    # and leave it on EndPlay, so they can be found via QueryRadius, QueryKNearest, etc.
+    spatialIndex = None
+
+    # Set to True to have instances register with the TickLODManager (see GetTickLODManager) on BeginPlay, so that they
+    # tick less often the farther they are from any player. Tick's dt is then the time since the last tick.
+    tickLOD = False
+
     def __init__(self):
         self.EndingPlay = Event() # fires (self) on EndPlay.
         super().__init__()
@@ -427,67 +427,29 @@ class AActor_PGLUE(metaclass=PyGlueMetaclass):
     def OnRep_loc(self): self.SetActorLocation(self.nr.loc)
     def OnRep_rot(self): self.SetActorRotation(self.nr.rot)
     def PostInitializeComponents(self): self.engineObj.SuperPostInitializeComponents()
-    def GetName(self): return self.engineObj.GetName()
-    def SetReplicates(self, b): self.engineObj.SetReplicates(b)
-    def SetCanBeDamaged(self, b): self.engineObj.SetCanBeDamaged(b)
-    def GetWorld(self): return self.engineObj.GetWorld()
-    def AddTickPrerequisiteActor(self, a): self.engineObj.AddTickPrerequisiteActor(a)
-    def AddTickPrerequisiteComponent(self, c): self.engineObj.AddTickPrerequisiteComponent(c)
-    def RemoveTickPrerequisiteActor(self, a): self.engineObj.RemoveTickPrerequisiteActor(a)
-    def RemoveTickPrerequisiteComponent(self, c): self.engineObj.RemoveTickPrerequisiteComponent(c)
-    def GetOwner(self): return self.engineObj.GetOwner()
-    def SetOwner(self, o): self.engineObj.SetOwner(o)
-    def GetTransform(self): return self.engineObj.GetTransform()
-    def SetActorLocation(self, v): self.engineObj.SetActorLocation(v)
-    def SetActorLocationAndRotation(self, v, r): self.engineObj.SetActorLocationAndRotation(v, r)
-    def GetActorLocation(self): return self.engineObj.GetActorLocation()
-    def GetActorRotation(self): return self.engineObj.GetActorRotation()
-    def GetActorQuat(self): return self.engineObj.GetActorQuat()
-    def GetActorTransform(self): return self.engineObj.GetActorTransform()
-    def SetActorTransform(self, t): self.engineObj.SetActorTransform(t)
-    def GetActorForwardVector(self): return self.engineObj.GetActorForwardVector()
-    def GetActorUpVector(self): return self.engineObj.GetActorUpVector()
-    def GetActorRightVector(self): return self.engineObj.GetActorRightVector()
-    def SetActorRotation(self, r): self.engineObj.SetActorRotation(r)
-    def GetActorScale3D(self): return self.engineObj.GetActorScale3D()
-    def SetActorScale3D(self, s): self.engineObj.SetActorScale3D(s)
-    def CreateUStaticMeshComponent(self, name): return self.engineObj.CreateUStaticMeshComponent(name)
     def GetComponentByName(self, name, incAllDescendents): return self.engineObj.GetComponentByName(name, incAllDescendents, COMPONENT_NAME_SUFFIX_SEPARATOR)
-    def GetRootComponent(self): return self.engineObj.GetRootComponent()
-    def SetRootComponent(self, s): self.engineObj.SetRootComponent(s)
-    def GetComponentsByClass(self, klass): return self.engineObj.GetComponentsByClass(klass)
-    def IsValid(self): return self.engineObj.IsValid()
-    def BeginPlay(self): self.engineObj.SuperBeginPlay()
+    def GetComponentByNameAndClass(self, name, klass): return self.engineObj.GetComponentByNameAndClass(name, klass, COMPONENT_NAME_SUFFIX_SEPARATOR)
+    def GetComponentsByTag(self, tag, klass=None): return self.engineObj.GetComponentsByTag(tag, klass)
+    def BeginPlay(self):
+        if self.spatialIndex:
+            GetSpatialIndex(self.spatialIndex).Add(self.engineObj)
+        if self.tickLOD:
+            GetTickLODManager().Register(self.engineObj)
+        self.engineObj.SuperBeginPlay()
     def EndPlay(self, reason):
+        if self.spatialIndex:
+            GetSpatialIndex(self.spatialIndex).Remove(self.engineObj)
+        if self.tickLOD:
+            GetTickLODManager().Unregister(self.engineObj)
         Event.UnbindOn(self)
         UnbindDelegatesOn(self)
         self.EndingPlay.Fire(self)
         self.engineObj.SuperEndPlay(reason)
     def Tick(self, dt): self.engineObj.SuperTick(dt)
-    def HasAuthority(self): return self.engineObj.HasAuthority()
-    def EnableInput(self, pc): self.engineObj.EnableInput(pc)
-    def DisableInput(self, pc): self.engineObj.DisableInput(pc)
-    def SetActorEnableCollision(self, e): self.engineObj.SetActorEnableCollision(e)
-    def GetActorEnableCollision(self): return self.engineObj.GetActorEnableCollision()
-    def IsActorTickEnabled(self): return self.engineObj.IsActorTickEnabled()
-    def SetActorTickEnabled(self, e): self.engineObj.SetActorTickEnabled(e)
-    def SetActorTickInterval(self, i): self.engineObj.SetActorTickInterval(i)
-    def GetActorTickInterval(self): return self.engineObj.GetActorTickInterval()
-    def SetActorHiddenInGame(self, h): self.engineObj.SetActorHiddenInGame(h)
-    def SetReplicateMovement(self, b): self.engineObj.SetReplicateMovement(b)
-    def Destroy(self): return self.engineObj.Destroy()
-    def IsPendingKillPending(self): return self.engineObj.IsPendingKillPending()
-    def Set(self, k, v): self.engineObj.Set(k, v)
-    def Get(self, k): return self.engineObj.Get(k)
+    def OnPoolAcquire(self, **kwargs): pass # called when taken from an ActorPool (see GetActorPool), with Acquire's kwargs, whether the actor is new or reused - reset any per-use state here
+    def OnPoolRelease(self): pass # called when given back to an ActorPool, just before it is hidden and deactivated
     def Call(self, funcName, *args): return self.engineObj.Call(funcName, *args)
-    def UpdateTickSettings(self, canEverTick, startWithTickEnabled): self.engineObj.UpdateTickSettings(canEverTick, startWithTickEnabled)
     def OnReplicated(self): pass
-    def AddTag(self, tag): self.engineObj.AddTag(tag)
-    def RemoveTag(self, tag): self.engineObj.RemoveTag(tag)
-    def AddMovementInput(self, worldDir, scale, force): self.engineObj.AddMovementInput(worldDir, scale, force)
-    def AddControllerPitchInput(self, v): self.engineObj.AddControllerPitchInput(v)
-    def AddControllerYawInput(self, v): self.engineObj.AddControllerYawInput(v)
-    def AddControllerRollInput(self, v): self.engineObj.AddControllerRollInput(v)
 
     def GetFilteredComponents(self, ofClass=UPrimitiveComponent, onlyVisible=True, ignore=None, ignoreTags=None, includeAttachedActors=False):
         '''Returns a list of all of this actor's visible mesh component (including descendants) that are instances of the
@@ -517,6 +479,18 @@ class AActor_PGLUE(metaclass=PyGlueMetaclass):
                 continue
             ret.append(comp)
         return ret
+FORWARDS(AActor_PGLUE, 'GetName', 'GetWorld', 'GetOwner', 'GetTransform', 'GetActorLocation', 'GetActorRotation',
+         'GetActorQuat', 'GetActorTransform', 'GetActorForwardVector', 'GetActorUpVector', 'GetActorRightVector',
+         'GetActorScale3D', 'CreateUStaticMeshComponent', 'GetRootComponent', 'GetComponentsByClass', 'IsValid',
+         'HasAuthority', 'GetActorEnableCollision', 'IsActorTickEnabled', 'GetActorTickInterval', 'Destroy',
+         'IsPendingKillPending', 'Get')
+FORWARDS(AActor_PGLUE, 'SetReplicates', 'SetCanBeDamaged', 'AddTickPrerequisiteActor', 'AddTickPrerequisiteComponent',
+         'RemoveTickPrerequisiteActor', 'RemoveTickPrerequisiteComponent', 'SetOwner', 'SetActorLocation',
+         'SetActorLocationAndRotation', 'SetActorTransform', 'SetActorRotation', 'SetActorScale3D', 'SetRootComponent',
+         'EnableInput', 'DisableInput', 'SetActorEnableCollision', 'SetActorTickEnabled', 'SetActorTickInterval',
+         'SetActorHiddenInGame', 'SetReplicateMovement', 'Set', 'UpdateTickSettings', 'AddTag', 'RemoveTag',
+         'AddMovementInput', 'AddControllerPitchInput', 'AddControllerYawInput', 'AddControllerRollInput',
+         returns=False)
 CPROPS(AActor_PGLUE, 'bAlwaysRelevant', 'bReplicates', 'Tags', 'SpawnCollisionHandlingMethod', 'bUseControllerRotationPitch', 'bUseControllerRotationYaw', 'InputComponent')
 
 class APawn_PGLUE(AActor_PGLUE):
@@ -524,24 +498,20 @@ class APawn_PGLUE(AActor_PGLUE):
         super().__init__(*args, **kwargs)
         self.SpawnCollisionHandlingMethod = enums.ESpawnActorCollisionHandlingMethod.AlwaysSpawn # drives me crazy that APawn overrides this
 
-    def IsLocallyControlled(self): return self.engineObj.IsLocallyControlled()
-    def GetController(self): return self.engineObj.GetController()
     def SetupPlayerInputComponent(self, comp): self.engineObj.SuperSetupPlayerInputComponent(comp)
-    def GetPlayerState(self): return self.engineObj.GetPlayerState()
     def PossessedBy(self, pc): pass # C++ calls super
     def UnPossessed(self): pass # C++ calls super
-    def GetMovementComponent(self): return self.engineObj.GetMovementComponent()
+FORWARDS(APawn_PGLUE, 'IsLocallyControlled', 'GetController', 'GetPlayerState', 'GetMovementComponent')
 CPROPS(APawn_PGLUE, 'AIControllerClass', 'AutoPossessPlayer', 'AutoPossessAI')
 
 class ACharacter_PGLUE(APawn_PGLUE):
-    def GetCharacterMovement(self): return self.engineObj.GetCharacterMovement()
-    def GetCapsuleComponent(self): return self.engineObj.GetCapsuleComponent()
-    def SetReplicateMovement(self, b): self.engineObj.SetReplicateMovement(b)
+    '''Glue class for ACharacter'''
+FORWARDS(ACharacter_PGLUE, 'GetCharacterMovement', 'GetCapsuleComponent')
+FORWARDS(ACharacter_PGLUE, 'SetReplicateMovement', returns=False)
 
 class USceneComponent_PGLUE(metaclass=PyGlueMetaclass):
     @classmethod
     def Cast(cls, obj): return cls.engineClass.Cast(obj)
-    def IsValid(self): return self.engineObj.IsValid()
     def TickComponent(self, dt, tickType): pass # C++ calls super::TickComponent already
     def BeginPlay(self): self.engineObj.SuperBeginPlay()
     def EndPlay(self, reason):
@@ -551,90 +521,49 @@ class USceneComponent_PGLUE(metaclass=PyGlueMetaclass):
         Event.UnbindOn(self)
         UnbindDelegatesOn(self)
         self.engineObj.SuperEndPlay(reason)
-    def SetComponentTickEnabled(self, t): self.engineObj.SetComponentTickEnabled(t)
     def OnRegister(self): self.engineObj.SuperOnRegister()
-    def ComponentHasTag(self, tag): return self.engineObj.ComponentHasTag(tag)
-    def GetOwner(self): return self.engineObj.GetOwner()
-    def GetName(self): return self.engineObj.GetName()
-    def SetIsReplicated(self, r): self.engineObj.SetIsReplicated(r)
-    def SetActive(self, a): self.engineObj.SetActive(a)
-    def IsRegistered(self): return self.engineObj.IsRegistered()
-    def RegisterComponent(self): self.engineObj.RegisterComponent()
-    def UnregisterComponent(self): self.engineObj.UnregisterComponent()
-    def DestroyComponent(self): self.engineObj.DestroyComponent()
-    def GetRelativeLocation(self): return self.engineObj.GetRelativeLocation()
-    def SetRelativeLocation(self, x): self.engineObj.SetRelativeLocation(x)
-    def GetRelativeRotation(self): return self.engineObj.GetRelativeRotation()
-    def SetRelativeRotation(self, x): self.engineObj.SetRelativeRotation(x)
-    def GetRelativeScale3D(self): return self.engineObj.GetRelativeScale3D()
-    def SetRelativeScale3D(self, x): self.engineObj.SetRelativeScale3D(x)
-    def GetRelativeTransform(self): return self.engineObj.GetRelativeTransform()
-    def SetRelativeTransform(self, x): self.engineObj.SetRelativeTransform(x)
-    def SetRelativeLocationAndRotation(self, loc, rot): self.engineObj.SetRelativeLocationAndRotation(loc, rot)
-    def ResetRelativeTransform(self): return self.engineObj.ResetRelativeTransform()
     def AttachToComponent(self, parent, socket=''): return self.engineObj.AttachToComponent(parent, socket)
     def SetupAttachment(self, parent, socket=''): return self.engineObj.SetupAttachment(parent, socket)
-    def DetachFromComponent(self): return self.engineObj.DetachFromComponent()
     def SetVisibility(self, vis, propagate=True): self.engineObj.SetVisibility(vis, propagate)
-    def IsVisible(self): return self.engineObj.IsVisible()
-    def GetHiddenInGame(self): return self.engineObj.GetHiddenInGame()
     def SetHiddenInGame(self, h, propagate=True): self.engineObj.SetHiddenInGame(h, propagate)
-    def GetForwardVector(self): return self.engineObj.GetForwardVector()
-    def GetRightVector(self): return self.engineObj.GetRightVector()
-    def GetUpVector(self): return self.engineObj.GetUpVector()
-    def GetComponentLocation(self): return self.engineObj.GetComponentLocation()
-    def GetComponentRotation(self): return self.engineObj.GetComponentRotation()
-    def GetComponentQuat(self): return self.engineObj.GetComponentQuat()
-    def GetComponentScale(self): return self.engineObj.GetComponentScale()
-    def GetComponentToWorld(self): return self.engineObj.GetComponentToWorld()
-    def GetAttachParent(self): return self.engineObj.GetAttachParent()
-    def GetChildrenComponents(self, includeAllDescendents): return self.engineObj.GetChildrenComponents(includeAllDescendents)
-    def SetWorldLocation(self, x): self.engineObj.SetWorldLocation(x)
-    def SetWorldRotation(self, x): self.engineObj.SetWorldRotation(x)
-    def SetWorldScale3D(self, s): self.engineObj.SetWorldScale3D(s)
-    def GetSocketTransform(self, name): return self.engineObj.GetSocketTransform(name)
-    def GetSocketLocation(self, name): return self.engineObj.GetSocketLocation(name)
-    def GetSocketRotation(self, name): return self.engineObj.GetSocketRotation(name)
-    def CalcBounds(self, locToWorld): return self.engineObj.CalcBounds(locToWorld)
-    def SetMobility(self, m): self.engineObj.SetMobility(m)
     def Show(self, visible, propagate=True, updateCollision=True): self.engineObj.Show(visible, propagate, updateCollision)
+FORWARDS(USceneComponent_PGLUE, 'IsValid', 'ComponentHasTag', 'GetOwner', 'GetName', 'IsRegistered',
+         'GetRelativeLocation', 'GetRelativeRotation', 'GetRelativeScale3D', 'GetRelativeTransform',
+         'ResetRelativeTransform', 'DetachFromComponent', 'IsVisible', 'GetHiddenInGame', 'GetForwardVector',
+         'GetRightVector', 'GetUpVector', 'GetComponentLocation', 'GetComponentRotation', 'GetComponentQuat',
+         'GetComponentScale', 'GetComponentToWorld', 'GetAttachParent', 'GetChildrenComponents', 'GetSocketTransform',
+         'GetSocketLocation', 'GetSocketRotation', 'CalcBounds')
+FORWARDS(USceneComponent_PGLUE, 'SetComponentTickEnabled', 'SetIsReplicated', 'SetActive', 'RegisterComponent',
+         'UnregisterComponent', 'DestroyComponent', 'SetRelativeLocation', 'SetRelativeRotation', 'SetRelativeScale3D',
+         'SetRelativeTransform', 'SetRelativeLocationAndRotation', 'SetWorldLocation', 'SetWorldRotation',
+         'SetWorldScale3D', 'SetMobility', returns=False)
 CPROPS(USceneComponent_PGLUE, 'ComponentTags', 'Bounds')
 
 class UPrimitiveComponent(USceneComponent_PGLUE):
-    def SetCollisionEnabled(self, e): self.engineObj.SetCollisionEnabled(e)
     def Show(self, visible, propagate=False, updateCollision=True): self.engineObj.Show(visible, propagate, updateCollision)
-    def SetCollisionObjectType(self, c): self.engineObj.SetCollisionObjectType(c)
-    def SetCollisionProfileName(self, name, updateOverlaps): self.engineObj.SetCollisionProfileName(name, updateOverlaps)
-    def SetCollisionResponseToAllChannels(self, r): self.engineObj.SetCollisionResponseToAllChannels(r)
-    def SetCollisionResponseToChannel(self, chan, r): self.engineObj.SetCollisionResponseToChannel(chan, r)
+FORWARDS(UPrimitiveComponent, 'SetCollisionEnabled', 'SetCollisionObjectType', 'SetCollisionProfileName',
+         'SetCollisionResponseToAllChannels', 'SetCollisionResponseToChannel', returns=False)
 
 class UBoxComponent_PGLUE(UPrimitiveComponent):
     def BeginPlay(self): self.engineObj.SuperBeginPlay()
     def OnRegister(self): self.engineObj.SuperOnRegister()
-    def SetBoxExtent(self, e): self.engineObj.SetBoxExtent(e)
-    def GetUnscaledBoxExtent(self): return self.engineObj.GetUnscaledBoxExtent()
     def TickComponent(self, dt, tickType): pass # C++ calls super::TickComponent already
+FORWARDS(UBoxComponent_PGLUE, 'GetUnscaledBoxExtent')
+FORWARDS(UBoxComponent_PGLUE, 'SetBoxExtent', returns=False)
 
 class UPawnMovementComponent_PGLUE(UPrimitiveComponent):
     def BeginPlay(self): self.engineObj.SuperBeginPlay()
     def OnRegister(self): self.engineObj.SuperOnRegister()
     def TickComponent(self, dt, tickType): pass # C++ calls super::TickComponent already
-    def ShouldSkipUpdate(self, dt): return self.engineObj.ShouldSkipUpdate(dt)
-    def SetUpdatedComponent(self, comp): return self.engineObj.SetUpdatedComponent(comp)
-    def GetUpdatedComponent(self): return self.engineObj.GetUpdatedComponent()
-    def SafeMoveUpdatedComponent(self, delta, newRot, sweep): return self.engineObj.SafeMoveUpdatedComponent(delta, newRot, sweep)
-    def SlideAlongSurface(self, delta, time, normal, collisionHit): return self.engineObj.SlideAlongSurface(delta, time, normal, collisionHit)
-    def GetPawnOwner(self): return self.engineObj.GetPawnOwner()
-    def ConsumeInputVector(self): return self.engineObj.ConsumeInputVector()
+FORWARDS(UPawnMovementComponent_PGLUE, 'ShouldSkipUpdate', 'SetUpdatedComponent', 'GetUpdatedComponent',
+         'SafeMoveUpdatedComponent', 'SlideAlongSurface', 'GetPawnOwner', 'ConsumeInputVector')
 CPROPS(UPawnMovementComponent_PGLUE, 'Velocity')
 
 class UVOIPTalker_PGLUE(metaclass=PyGlueMetaclass):
     @classmethod
     def Cast(cls, obj): return cls.engineClass.Cast(obj)
-    def IsValid(self): return self.engineObj.IsValid()
-    def SetIsReplicated(self, r): self.engineObj.SetIsReplicated(r)
-    def RegisterWithPlayerState(self, ps): self.engineObj.RegisterWithPlayerState(ps)
-    def GetVoiceLevel(self): return self.engineObj.GetVoiceLevel()
+FORWARDS(UVOIPTalker_PGLUE, 'IsValid', 'GetVoiceLevel')
+FORWARDS(UVOIPTalker_PGLUE, 'SetIsReplicated', 'RegisterWithPlayerState', returns=False)
 
 class UEPYAssistantActor(AActor_PGLUE):
     '''Spawn one of these into a level to have it watch for source code changes and automatically reload modified code.'''
@@ -95,6 +95,9 @@ class ECollisionResponse(Enum):
     Overlap = ECR_Overlap
     Block = ECR_Block
 
+class EQueryMobilityType(Enum):
+    Any, Static, Dynamic = range(3)
+
 class EEasingFunc(Enum):
     Linear, Step, SinusoidalIn, SinusoidalOut, SinusoidalInOut, EaseIn, EaseOut, EaseInOut, ExpoIn, ExpoOut, ExpoInOut, CircularIn, CircularOut, CircularInOut = range(14)
 
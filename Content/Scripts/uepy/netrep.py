@@ -2,7 +2,8 @@
 Python side of network replication (aka NetRep or NR) code. Misc info/notes:
 - Any object (not just actors) can declare itself as replicated and send/receive network messages; each object that does so needs to
     have a unique network name/ID known as the netID.
-- Replicated objects declare an optional 'repProps' Bag that lists all its replicated properties and their default values.
+- Replicated objects declare an optional 'repProps' Bag that lists all its replicated properties and their default values. At runtime
+    the values live in self.nr, an instance of a __slots__ record class generated once per class from the merged repProps (NRRecord).
 - Replicated objects have an OnReplicated method that is called once the object is fully replicated; for replicated actors, this is
     effectively BeginPlay (and they should generally not use BeginPlay at all).
 - Replicated objects can optionally declare that they depend on other replicated objects in order to function properly, in which case
@@ -107,7 +108,8 @@ TODO:
 
 from uepy import *
 from uepy.enums import *
-import struct, weakref, time, random, inspect, threading
+import struct, weakref, time, random, inspect, threading, operator
+from collections.abc import MutableMapping
 
 class ENRBridgeMessage(Enum): NONE, Hello, SigDef, SetChannelInfo, FragmentMapping, ObjInitialState, InitialStateComplete, Call, Unregister, Update = range(10)
 
@@ -359,7 +361,7 @@ class NRAppBridge:
         # Create an ordered list of repProp values - no need for naming them since the receiving side knows the same prop ordering
         # send the format string for repprops (len+str) and the blob of data (len+data) for it
         #log('XXX netrep.SISF', obj.nrNetID, netIDNum, ' '.join(['%d:%s' % (i,k) for i,k in enumerate(obj.nrPropNames)]))
-        formatStr, propsBlob = ValuesToBin([obj.nr[k] for k in obj.nrPropNames])
+        formatStr, propsBlob = ValuesToBin(obj.nr.values())
         PA(struct.pack('<BH', len(formatStr), len(propsBlob)))
         PA(formatStr.encode('utf8'))
         PA(propsBlob)
@@ -626,9 +628,9 @@ class NRAppBridge:
                 propNames.append(propName)
 
                 try:
-                    propIndex = recipient.nrPropNames.index(propName)
+                    propIndex = recipient.nr._indices[propName]
                     pairs.append((f'{updateAction}{propIndex}', value))
-                except ValueError:
+                except KeyError:
                     invalidNames.append(propName)
                     continue
             assert not invalidNames, 'NRUpdate called with one or more invalid property names: ' + repr(invalidNames)
@@ -967,7 +969,7 @@ class NRAppBridge:
             else:
                 # obj hasn't replicated yet, so just apply the changes directly
                 for name, value in finalChanges:
-                    setattr(obj.nr, name, value)
+                    obj.nr[name] = value
         except:
             logTB()
 
@@ -1042,7 +1044,7 @@ class NRAppBridge:
         # We have this object's state, so set its repProp values - we received just an ordered list of values since we know
         # the property names already.
         for propName, propValue in zip(obj.nrPropNames, state.propValues):
-            setattr(obj.nr, propName, propValue)
+            obj.nr[propName] = propValue
 
         # Also resolve or set up tracking of any replicated objects this object depends on
         waitingFor = [] # netIDs of objs that have not yet arrived
@@ -1180,6 +1182,106 @@ class NRWrappedDefault:
     def __init__(self, defaultValue):
         self.defaultValue = defaultValue
 
+class NRRecord(MutableMapping):
+    '''Base class of the record types that hold replicated property values (self.nr). A record type is generated once per
+    NetReplicated subclass (see NRRecordClassFor) with a __slots__ entry for each of the class's merged repProps, so reading
+    self.nr.foo is a plain slot lookup, and creating one copies all the defaults in a single generated statement.
+    It is a (mutable) Mapping, so the dict API (get, keys, values, items, update, in, len, iteration) still works, but it is
+    not a dict: use dict(obj.nr) or obj.nr.copy() to get one, e.g. for json. Setting a name that isn't a repProp, or removing
+    one, raises an error.
+    Each record has a dirty bitmask with one bit per repProp (by index). Setting a repProp, either as obj.nr.foo = value or
+    obj.nr['foo'] = value (which is what NR itself uses for all updates), sets its bit; Dirty() returns the names whose bits
+    are set and ClearDirty() clears them.'''
+    __slots__ = ('_dirty',)
+    _names = () # the class's repProp names, in index order
+    _indices = {} # name -> index
+    _defaults = () # default values, in index order
+    _propInfo = {} # name -> Bag(index, type, default, rawDefault)
+    _getAll = staticmethod(lambda rec: ())
+
+    def __getitem__(self, name):
+        if name not in self._indices:
+            raise KeyError(name)
+        return getattr(self, name)
+
+    def __setitem__(self, name, value):
+        if name not in self._indices:
+            raise KeyError('%r is not a repProp of %s' % (name, type(self).__name__))
+        setattr(self, name, value)
+
+    def __delitem__(self, name): raise TypeError('repProps cannot be removed')
+    def __contains__(self, name): return name in self._indices
+    def __iter__(self): return iter(self._names)
+    def __len__(self): return len(self._names)
+    def __repr__(self): return '<%s %s>' % (type(self).__name__, ' '.join('%s=%r' % (k, getattr(self, k)) for k in self._names))
+    def values(self): return self._getAll(self) # tuple of all values, in index order
+    def copy(self): return Bag(zip(self._names, self._getAll(self)))
+    def Dirty(self):
+        dirty = self._dirty
+        return [name for i, name in enumerate(self._names) if dirty & (1 << i)]
+    def ClearDirty(self): _setDirty(self, 0)
+
+_setDirty = NRRecord.__dict__['_dirty'].__set__ # sets the slot directly, bypassing the generated __setattr__s
+
+def NRRecordClassFor(klass):
+    '''Returns the record class (see NRRecord) for the given NetReplicated subclass, generating it on first use'''
+    rc = klass.__dict__.get('_nrRecordClass') # looked up on this class only, since subclasses have their own merged repProps
+    if rc is not None:
+        return rc
+
+    # Merge the repProps of the whole class hierarchy. By convention, properties are referenced by index in alphabetical order,
+    # and no object can have more than 255 replicated properties.
+    allProps = {}
+    for k in klass.__mro__[::-1]: # reverse order so we start at the top of the MRO list
+        allProps.update(getattr(k, 'repProps', {}))
+    names = tuple(sorted(allProps.keys()))
+    clashes = [n for n in names if hasattr(NRRecord, n)]
+    if clashes:
+        raise AttributeError('%s has repProps whose names clash with NRRecord attributes: %s' % (klass.__name__, ', '.join(clashes)))
+    defaults = []
+    propInfo = {}
+    for i, propName in enumerate(names):
+        v = rawV = allProps[propName]
+        if isinstance(v, NRWrappedDefault):
+            v = v.defaultValue
+        defaults.append(v)
+        propInfo[propName] = Bag(index=i, type=type(v), default=v, rawDefault=rawV)
+
+    if len(names) > 1:
+        getAll = operator.attrgetter(*names)
+    elif names:
+        getter = operator.attrgetter(names[0])
+        getAll = lambda rec: (getter(rec),)
+    else:
+        getAll = lambda rec: ()
+
+    # setting a repProp sets its dirty bit; anything else falls through to the slots, which reject names that aren't repProps
+    bits = {n:1 << i for i,n in enumerate(names)}
+    objSet = object.__setattr__
+    def __setattr__(self, name, value):
+        bit = bits.get(name)
+        if bit is not None:
+            _setDirty(self, self._dirty | bit)
+        objSet(self, name, value)
+
+    rc = type(klass.__name__ + '_NR', (NRRecord,), dict(__slots__=names, __setattr__=__setattr__, _names=names,
+        _indices={n:i for i,n in enumerate(names)}, _defaults=tuple(defaults), _propInfo=propInfo, _getAll=staticmethod(getAll)))
+
+    # generate an __init__ that sets all the slots at once, via the slot descriptors so that it skips __setattr__ and
+    # starts out with nothing dirty
+    g = {'_setDirty':_setDirty, '_defaults':tuple(defaults)}
+    body = ['    _setDirty(self, 0)']
+    if names:
+        body.insert(0, '    %s, = _defaults' % ', '.join('_d%d' % i for i in range(len(names))))
+        for i, n in enumerate(names):
+            g['_s%d' % i] = rc.__dict__[n].__set__
+            body.append('    _s%d(self, _d%d)' % (i, i))
+    ns = {}
+    exec('def __init__(self):\n' + '\n'.join(body), g, ns)
+    rc.__init__ = ns['__init__']
+    klass._nrRecordClass = rc
+    return rc
+
 class NetReplicated(metaclass=NRTrackerMetaclass):
     '''Mixin class to add to any class (doesn't have to be an actor) that wants to use network
     replication'''
@@ -1201,22 +1303,11 @@ class NetReplicated(metaclass=NRTrackerMetaclass):
         self.nrFragments = {} # fragment name -> NRFragment instance
         self.nrQueuedElementUpdates = {} # {(fragmentID, elementIndex) -> [(propIndex, propValue)]} - undelivered updates to fragment elements
 
-        # Generate the full set of replicated properties and set them to their defaults. By convention, properties
-        # are referenced by index in alphabetical order, and no object can have more than 255 replicated properties.
-        allProps = Bag()
-        for klass in self.__class__.__mro__[::-1]: # reverse order so we start at the top of the MRO list
-            allProps.update(**getattr(klass, 'repProps', {}))
-        self.nrPropNames = sorted(allProps.keys()) # the official, ordered list of valid replicated property names for this object
-
-        propInfo = {} # prop name -> Bag of info about it
-        self.nr = Bag() # At some point we may make this a read-only struct so you have to use NRUpdate
-        for i, propName in enumerate(self.nrPropNames):
-            v = rawV = allProps[propName]
-            if isinstance(v, NRWrappedDefault):
-                v = v.defaultValue
-            self.nr[propName] = v
-            propInfo[propName] = Bag(index=i, type=type(v), default=v, rawDefault=rawV)
-        self.nrPropInfo = propInfo # in case apps need to extract info for other purposes
+        # Set up the full set of replicated properties with their defaults
+        rc = NRRecordClassFor(self.__class__)
+        self.nr = rc() # At some point we may make this a read-only struct so you have to use NRUpdate
+        self.nrPropNames = rc._names # the official, ordered list of valid replicated property names for this object
+        self.nrPropInfo = rc._propInfo # in case apps need to extract info for other purposes
 
     def NRIsLocallyControlled(self):
         '''Returns True if this copy of this object (versus the copies of it running on other machines) is the copy that is being
@@ -1348,7 +1439,7 @@ class NetReplicated(metaclass=NRTrackerMetaclass):
         to be called.'''
         # The default convention is that all values in this update are applied before any OnRep methods are called
         for name, value in changes:
-            setattr(self.nr, name, value)
+            self.nr[name] = value
 
         if not self.nrOnReplicatedCalled:
             log('WARNING: OnNRUpdate not calling OnRep handlers because object has not fully replicated yet', self)
@@ -0,0 +1,135 @@
+#include "ActorPool.h"
+#include "common.h"
+#include "IUEPYGlueMixin.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/World.h"
+
+static TMap<TPair<FObjectKey, FObjectKey>, std::shared_ptr<FActorPool>> allPools;
+static FDelegateHandle worldCleanupHandle;
+
+// drops all pools for a world that is going away. Their idle actors go away with the world, so they just get forgotten.
+static void _OnWorldCleanup(UWorld* world, bool sessionEnded, bool cleanupResources)
+{
+    for (auto it = allPools.CreateIterator(); it; ++it)
+    {
+        FActorPool* pool = it->Value.get();
+        if (pool->world.Get() != world && pool->world.IsValid())
+            continue;
+        pool->world.Reset();
+        pool->DestroyIdle();
+        it.RemoveCurrent();
+    }
+}
+
+std::shared_ptr<FActorPool> FActorPool::Get(UWorld* world, UClass* klass)
+{
+    if (!worldCleanupHandle.IsValid())
+        worldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&_OnWorldCleanup);
+
+    TPair<FObjectKey, FObjectKey> key(world, klass);
+    std::shared_ptr<FActorPool>* existing = allPools.Find(key);
+    if (existing)
+        return *existing;
+    std::shared_ptr<FActorPool> pool = std::make_shared<FActorPool>(world, klass);
+    allPools.Add(key, pool);
+    return pool;
+}
+
+// calls the given method on the actor's Python instance, if it has one and the method exists
+static void _CallPoolHook(AActor* actor, const char* method, py::dict* kwargs)
+{
+    IUEPYGlueMixin* p = Cast<IUEPYGlueMixin>(actor);
+    if (!p || !p->pyInst || !py::hasattr(p->pyInst, method))
+        return;
+    try {
+        if (kwargs)
+            p->pyInst.attr(method)(**(*kwargs));
+        else
+            p->pyInst.attr(method)();
+    } catchpy;
+}
+
+bool FActorPool::PopIdle(FIdle& out)
+{
+    while (idle.Num())
+    {
+        out = idle.Pop(false);
+        idleSet.Remove(out.key);
+        AActor* actor = out.actor.Get();
+        if (IsValid(actor) && !actor->IsPendingKillPending())
+            return true;
+        // else it was destroyed out from under us
+    }
+    return false;
+}
+
+void FActorPool::Activate(AActor* actor, const FTransform& transform, py::dict& kwargs, const FIdle* reused)
+{
+    numAcquired++;
+    if (reused)
+    {   // move it into place before it can collide or tick anywhere
+        numReused++;
+        actor->SetActorTransform(transform, false, nullptr, ETeleportType::ResetPhysics);
+        actor->SetActorHiddenInGame(false);
+        actor->SetActorEnableCollision(reused->collisionEnabled);
+        actor->SetActorTickEnabled(reused->tickEnabled);
+        for (const TWeakObjectPtr<UActorComponent>& comp : reused->tickingComps)
+            if (comp.IsValid())
+                comp->SetComponentTickEnabled(true);
+    }
+    else
+        numSpawned++;
+    _CallPoolHook(actor, "OnPoolAcquire", &kwargs);
+}
+
+void FActorPool::Release(AActor* actor, bool prewarming)
+{
+    if (!IsValid(actor) || actor->IsPendingKillPending())
+        return;
+    UClass* k = klass.Get();
+    if (!k || actor->GetClass() != k)
+    {
+        LERROR("Cannot release %s into a pool for a different class", *actor->GetName());
+        return;
+    }
+    if (idleSet.Contains(actor))
+        return; // already released
+
+    if (!prewarming)
+        numReleased++;
+    _CallPoolHook(actor, "OnPoolRelease", nullptr);
+    FIdle entry;
+    entry.actor = actor;
+    entry.key = actor;
+    entry.tickEnabled = actor->IsActorTickEnabled();
+    entry.collisionEnabled = actor->GetActorEnableCollision();
+    for (UActorComponent* comp : actor->GetComponents())
+    {
+        if (comp && comp->IsComponentTickEnabled())
+        {
+            entry.tickingComps.Emplace(comp);
+            comp->SetComponentTickEnabled(false);
+        }
+    }
+    actor->SetActorHiddenInGame(true);
+    actor->SetActorTickEnabled(false);
+    actor->SetActorEnableCollision(false);
+    idle.Emplace(MoveTemp(entry));
+    idleSet.Add(actor);
+}
+
+void FActorPool::DestroyIdle()
+{
+    TArray<FIdle> toDestroy = MoveTemp(idle);
+    idle.Reset();
+    idleSet.Reset();
+    if (!world.IsValid())
+        return; // the world took them with it
+    for (FIdle& entry : toDestroy)
+    {
+        AActor* actor = entry.actor.Get();
+        if (IsValid(actor) && !actor->IsPendingKillPending())
+            actor->Destroy();
+    }
+}
+
@@ -0,0 +1,54 @@
+// Pools of actors of a single class, so that gameplay code that constantly creates and destroys the same kinds of actors
+// (projectiles, effects) can reuse them instead: a released actor is hidden, and it and its components stop ticking and it
+// loses its collision until it is acquired again, so it costs nothing but memory in the meantime, and reusing it skips the
+// whole spawn path (including, for Python subclasses, the construction of a new Python instance). Python glue instances
+// get OnPoolAcquire(**kwargs) and OnPoolRelease() calls so they can reset their state.
+//
+// Pools are per world + class and are owned here, not by Python: GetActorPool always returns the same pool for a given
+// world and class, and the pool (and the idle actors it holds) is torn down when its world is cleaned up. A pool that
+// Python still holds on to after that just refuses to do anything.
+
+#pragma once
+
+#include "uepy.h"
+#include <memory>
+
+class FActorPool
+{
+public:
+    // an actor sitting in the pool, plus what it had turned on when it was released, so acquiring it can turn it back on
+    struct FIdle
+    {
+        TWeakObjectPtr<AActor> actor;
+        AActor* key = nullptr; // what's in idleSet
+        bool tickEnabled = false;
+        bool collisionEnabled = false;
+        TArray<TWeakObjectPtr<UActorComponent>> tickingComps; // components that were ticking
+    };
+
+private:
+    TArray<FIdle> idle;
+    TSet<AActor*> idleSet; // for quickly rejecting double releases; never deref'd
+
+public:
+    TWeakObjectPtr<UWorld> world; // reset once the world has been cleaned up
+    TWeakObjectPtr<UClass> klass;
+
+    // stats
+    int32 numSpawned = 0; // actors this pool has had to spawn (including prewarming)
+    int32 numAcquired = 0;
+    int32 numReused = 0; // acquires that were satisfied by an idle actor
+    int32 numReleased = 0;
+
+    FActorPool(UWorld* _world, UClass* _klass) : world(_world), klass(_klass) {}
+
+    // gets (creating if needed) the pool for the given world and class
+    static std::shared_ptr<FActorPool> Get(UWorld* world, UClass* klass);
+
+    int32 NumIdle() const { return idle.Num(); }
+    bool PopIdle(FIdle& out); // false if there aren't any
+    void Activate(AActor* actor, const FTransform& transform, py::dict& kwargs, const FIdle* reused); // reused is null for new actors
+    void Release(AActor* actor, bool prewarming=false); // prewarming releases don't count in the stats
+    void DestroyIdle();
+};
+
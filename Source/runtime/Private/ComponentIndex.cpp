@@ -0,0 +1,140 @@
+#include "ComponentIndex.h"
+#include "common.h"
+
+static TMap<AActor*, TUniquePtr<FComponentIndex>> allIndices; // keys are never deref'd
+static int32 purgeThreshold = 64;
+
+FComponentIndex* FComponentIndex::Get(AActor* actor)
+{
+    if (!IsValid(actor))
+        return nullptr;
+
+    TUniquePtr<FComponentIndex>* existing = allIndices.Find(actor);
+    if (!existing)
+    {   // every so often drop the indices of actors that have gone away
+        if (allIndices.Num() >= purgeThreshold)
+        {
+            for (auto it = allIndices.CreateIterator(); it; ++it)
+                if (!it->Value->actor.IsValid())
+                    it.RemoveCurrent();
+            purgeThreshold = FMath::Max(64, allIndices.Num() * 2);
+        }
+        existing = &allIndices.Add(actor, MakeUnique<FComponentIndex>());
+    }
+
+    FComponentIndex* index = existing->Get();
+    if (index->actor.Get() != actor) // new actor, or a new actor that reused the address of an old one
+    {
+        index->actor = actor;
+        index->dirty = true;
+    }
+    if (index->dirty || index->numComps != actor->GetComponents().Num())
+        index->Build(actor);
+    return index;
+}
+
+void FComponentIndex::Invalidate(AActor* actor)
+{
+    TUniquePtr<FComponentIndex>* existing = actor ? allIndices.Find(actor) : nullptr;
+    if (existing)
+        (*existing)->dirty = true;
+}
+
+void FComponentIndex::InvalidateAttachChain(USceneComponent* comp)
+{
+    for (; comp; comp = comp->GetAttachParent())
+        Invalidate(comp->GetOwner());
+}
+
+void FComponentIndex::Build(AActor* a)
+{
+    byName.Reset();
+    byStrippedName.Reset();
+    byTag.Reset();
+    const TSet<UActorComponent*>& comps = a->GetComponents();
+    numComps = comps.Num();
+    dirty = false;
+    for (UActorComponent* comp : comps)
+    {
+        if (!IsValid(comp))
+            continue;
+        byName.FindOrAdd(comp->GetFName()).Emplace(comp);
+        for (FName& tag : comp->ComponentTags)
+            byTag.FindOrAdd(tag).AddUnique(comp);
+    }
+
+    // comps of other actors (e.g. child actors) that are attached under our root can be found by name too
+    USceneComponent* root = a->GetRootComponent();
+    if (root)
+    {
+        TArray<USceneComponent*> kids;
+        root->GetChildrenComponents(true, kids);
+        for (USceneComponent* kid : kids)
+            if (IsValid(kid) && kid->GetOwner() != a)
+                byName.FindOrAdd(kid->GetFName()).Emplace(kid);
+    }
+}
+
+bool FComponentIndex::IsStillValid(UActorComponent* comp) const
+{
+    if (!IsValid(comp) || comp->IsPendingKill())
+        return false;
+    AActor* a = actor.Get();
+    if (comp->GetOwner() == a)
+        return true;
+    USceneComponent* sc = Cast<USceneComponent>(comp);
+    USceneComponent* root = a ? a->GetRootComponent() : nullptr;
+    return sc && root && sc->IsAttachedTo(root);
+}
+
+UActorComponent* FComponentIndex::FindIn(TMap<FName, CompList>& map, FName name, TFunctionRef<bool(UActorComponent*)> filter)
+{
+    CompList* candidates = map.Find(name);
+    if (!candidates)
+        return nullptr;
+    for (TWeakObjectPtr<UActorComponent>& weak : *candidates)
+    {
+        UActorComponent* comp = weak.Get();
+        if (!IsStillValid(comp))
+            dirty = true; // something went away without us hearing about it, so rebuild next time
+        else if (filter(comp))
+            return comp;
+    }
+    return nullptr;
+}
+
+UActorComponent* FComponentIndex::FindByName(FName name, const FString& suffixSeparator, TFunctionRef<bool(UActorComponent*)> filter)
+{
+    UActorComponent* found = FindIn(byName, name, filter);
+    if (found || suffixSeparator.IsEmpty())
+        return found;
+
+    TMap<FName, CompList>* stripped = byStrippedName.Find(suffixSeparator);
+    if (!stripped)
+    {   // first lookup with this separator since the last build
+        stripped = &byStrippedName.Add(suffixSeparator);
+        for (auto& pair : byName)
+        {
+            FString left, right;
+            if (pair.Key.ToString().Split(suffixSeparator, &left, &right))
+                stripped->FindOrAdd(FName(*left)).Append(pair.Value);
+        }
+    }
+    return FindIn(*stripped, name, filter);
+}
+
+void FComponentIndex::FindByTag(FName tag, TFunctionRef<bool(UActorComponent*)> filter, TArray<UActorComponent*>& out)
+{
+    CompList* candidates = byTag.Find(tag);
+    if (!candidates)
+        return;
+    for (TWeakObjectPtr<UActorComponent>& weak : *candidates)
+    {
+        UActorComponent* comp = weak.Get();
+        if (!IsStillValid(comp) || !comp->ComponentHasTag(tag))
+            dirty = true;
+        else if (filter(comp))
+            out.Emplace(comp);
+    }
+}
+
@@ -0,0 +1,44 @@
+// per-actor lookup tables for finding an actor's components by name or by tag, so that per-frame lookups from Python don't
+// have to walk the actor's components and compare strings every time. An actor's index is built on first use and rebuilt
+// whenever it has been invalidated (the uepy register/unregister/destroy/attach/tag bindings do that) or the actor's component
+// count no longer matches what it was when the index was built (which catches components added or removed elsewhere).
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+class FComponentIndex
+{
+    typedef TArray<TWeakObjectPtr<UActorComponent>> CompList;
+
+    TWeakObjectPtr<AActor> actor;
+    int32 numComps = 0; // how many components the actor had when we last built
+    bool dirty = true;
+    TMap<FName, CompList> byName; // full names
+    TMap<FString, TMap<FName, CompList>> byStrippedName; // suffix separator --> names with the suffix stripped off; built on demand
+    TMap<FName, CompList> byTag;
+
+    void Build(AActor* a);
+    bool IsStillValid(UActorComponent* comp) const;
+    UActorComponent* FindIn(TMap<FName, CompList>& map, FName name, TFunctionRef<bool(UActorComponent*)> filter);
+
+public:
+    // gets (building or rebuilding if needed) the index for the given actor
+    static FComponentIndex* Get(AActor* actor);
+
+    // flags an actor's index as needing a rebuild. Call this when components are registered or unregistered, attached
+    // or detached, or when their tags change.
+    static void Invalidate(AActor* actor);
+    static void Invalidate(UActorComponent* comp) { if (comp) Invalidate(comp->GetOwner()); }
+    static void InvalidateAttachChain(USceneComponent* comp); // invalidates the owners of comp and everything it's attached under
+
+    // returns the first component with the given name for which filter returns true, or nullptr. Components owned by the
+    // actor are indexed, as are components owned by other actors that are attached somewhere under the actor's root.
+    // If suffixSeparator isn't empty, names with everything from the separator on stripped off also match (see
+    // uepy/__init__.py COMPONENT_NAME_SUFFIX_SEPARATOR).
+    UActorComponent* FindByName(FName name, const FString& suffixSeparator, TFunctionRef<bool(UActorComponent*)> filter);
+
+    // appends to out each component with the given tag for which filter returns true
+    void FindByTag(FName tag, TFunctionRef<bool(UActorComponent*)> filter, TArray<UActorComponent*>& out);
+};
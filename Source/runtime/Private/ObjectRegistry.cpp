@@ -0,0 +1,562 @@
+#include "ObjectRegistry.h"
+#include "common.h"
+#include "UObject/UObjectHash.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+FObjectRegistry& FObjectRegistry::Get()
+{
+    static FObjectRegistry* registry = new FObjectRegistry(); // leaked on purpose, it has to outlive GUObjectArray's listener lists
+    return *registry;
+}
+
+int32 FObjectRegistry::Track(UClass* klass)
+{
+    int32 slot = INDEX_NONE;
+    {
+        FScopeLock scope(&lock);
+        for (int32 i=0; i < tracked.Num(); i++)
+        {
+            UClass* k = tracked[i].klass.Get();
+            if (k == klass)
+                return i;
+            if (!k && slot == INDEX_NONE)
+                slot = i; // reuse the slot of a class that went away
+        }
+
+        if (!listening)
+        {
+            GUObjectArray.AddUObjectCreateListener(this);
+            GUObjectArray.AddUObjectDeleteListener(this);
+            postGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([this]()
+            {   // classes may have been GC'd (and their addresses reused), so the cache can't be trusted anymore
+                FScopeLock scope(&lock);
+                classToTracked.Empty();
+            });
+            listening = true;
+        }
+
+        if (slot == INDEX_NONE)
+            slot = tracked.AddDefaulted();
+        tracked[slot].klass = klass;
+        tracked[slot].indices.Empty();
+        classToTracked.Empty();
+    }
+
+    // seed it with what already exists. Done outside of the lock because the engine takes its own hash table lock here;
+    // anything created in the meantime has already been added by NotifyUObjectCreated.
+    TArray<int32> existing;
+    ForEachObjectOfClass(klass, [&existing](UObject* obj) { existing.Emplace(GUObjectArray.ObjectToIndex(obj)); }, true, RF_NoFlags);
+    FScopeLock scope(&lock);
+    tracked[slot].indices.Append(existing);
+    return slot;
+}
+
+const TArray<int32>& FObjectRegistry::GetTrackedFor(const UClass* klass)
+{
+    TArray<int32>* cached = classToTracked.Find(klass);
+    if (cached)
+        return *cached;
+
+    TArray<int32> slots;
+    for (int32 i=0; i < tracked.Num(); i++)
+    {
+        UClass* k = tracked[i].klass.Get();
+        if (k && klass->IsChildOf(k))
+            slots.Emplace(i);
+    }
+    return classToTracked.Add(klass, slots);
+}
+
+void FObjectRegistry::GetObjects(UClass* klass, UWorld* world, TArray<FWeakObjectPtr>& out)
+{
+    if (!klass)
+        return;
+    int32 slot = Track(klass);
+    TArray<int32> indices;
+    {
+        FScopeLock scope(&lock);
+        indices = tracked[slot].indices.Array();
+    }
+
+    for (int32 index : indices)
+    {
+        FUObjectItem* item = GUObjectArray.IndexToObject(index);
+        UObject* obj = item ? (UObject*)item->Object : nullptr;
+        if (!obj || item->IsPendingKill() || item->IsUnreachable())
+            continue;
+        if (obj->HasAnyFlags(RF_ClassDefaultObject) || obj->HasAnyInternalFlags(EInternalObjectFlags::AsyncLoading))
+            continue;
+        if (!obj->IsA(klass)) // the slot got reused by some other object since we last heard about it
+            continue;
+        if (world && obj->GetWorld() != world)
+            continue;
+        out.Emplace(obj);
+    }
+}
+
+int32 FObjectRegistry::NumTrackedClasses()
+{
+    FScopeLock scope(&lock);
+    int32 count = 0;
+    for (FTrackedClass& t : tracked)
+        if (t.klass.IsValid())
+            count++;
+    return count;
+}
+
+void FObjectRegistry::NotifyUObjectCreated(const UObjectBase* obj, int32 index)
+{
+    UClass* klass = obj->GetClass();
+    if (!klass)
+        return;
+    FScopeLock scope(&lock);
+    for (int32 slot : GetTrackedFor(klass))
+        tracked[slot].indices.Add(index);
+}
+
+void FObjectRegistry::NotifyUObjectDeleted(const UObjectBase* obj, int32 index)
+{   // by now the object's class may already be gone, so we can't use it to find which sets it's in
+    FScopeLock scope(&lock);
+    for (FTrackedClass& t : tracked)
+        t.indices.Remove(index);
+}
+
+void FObjectRegistry::OnUObjectArrayShutdown()
+{
+    GUObjectArray.RemoveUObjectCreateListener(this);
+    GUObjectArray.RemoveUObjectDeleteListener(this);
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(postGCHandle);
+    listening = false;
+}
+
+FObjectNameIndex& FObjectNameIndex::Get()
+{
+    static FObjectNameIndex* index = new FObjectNameIndex(); // leaked on purpose, see FObjectRegistry::Get
+    return *index;
+}
+
+void FObjectNameIndex::Start()
+{
+    if (listening)
+        return;
+    GUObjectArray.AddUObjectCreateListener(this);
+    GUObjectArray.AddUObjectDeleteListener(this);
+    listening = true;
+    for (int32 i=0; i < GUObjectArray.GetObjectArrayNum(); i++)
+    {
+        FUObjectItem* item = GUObjectArray.IndexToObject(i);
+        if (item && item->Object)
+            AddLocked(i, item->Object->GetFName());
+    }
+}
+
+// the string for a base name, i.e. the name without its number
+static FString _BaseNameString(FNameEntryId id)
+{
+    return FName(id, id, NAME_NO_NUMBER_INTERNAL).ToString();
+}
+
+void FObjectNameIndex::AddLocked(int32 index, FName name)
+{
+    if (name.IsNone())
+        return; // which nothing should be named anyway
+    if (index >= slotNames.Num())
+        slotNames.SetNum(FMath::Max(index + 1, slotNames.Num() * 2));
+    byName.FindOrAdd(name).Emplace(index);
+    FNameEntryId base = name.GetComparisonIndex();
+    TArray<int32>* baseIndices = byBase.Find(base);
+    if (!baseIndices)
+    {   // first object with this base (or first since they all went away)
+        baseIndices = &byBase.Add(base);
+        FBase entry;
+        entry.name = _BaseNameString(base);
+        entry.id = base;
+        newBases.Emplace(MoveTemp(entry));
+    }
+    baseIndices->Emplace(index);
+    slotNames[index] = name;
+    num++;
+}
+
+void FObjectNameIndex::RemoveLocked(int32 index)
+{
+    if (!slotNames.IsValidIndex(index) || slotNames[index].IsNone())
+        return;
+    FName name = slotNames[index];
+    slotNames[index] = NAME_None;
+    num--;
+    TArray<int32>* indices = byName.Find(name);
+    if (indices)
+    {
+        indices->RemoveSwap(index);
+        if (indices->Num() == 0)
+            byName.Remove(name);
+    }
+    FNameEntryId base = name.GetComparisonIndex();
+    indices = byBase.Find(base);
+    if (indices)
+    {
+        indices->RemoveSwap(index);
+        if (indices->Num() == 0)
+        {
+            byBase.Remove(base);
+            numStaleBases++; // its sortedBases entry (if any) gets dropped the next time they're sorted
+        }
+    }
+}
+
+void FObjectNameIndex::SortBasesLocked()
+{
+    if (newBases.Num() == 0 && numStaleBases <= sortedBases.Num() / 4)
+        return;
+    auto less = [](const FBase& a, const FBase& b) { return FCString::Stricmp(*a.name, *b.name) < 0; };
+    newBases.Sort(less);
+
+    // merge the two sorted lists, dropping bases that have gone away (and duplicates, from bases that went away and came back)
+    TArray<FBase> merged;
+    merged.Reserve(sortedBases.Num() + newBases.Num());
+    int32 a = 0, b = 0;
+    while (a < sortedBases.Num() || b < newBases.Num())
+    {
+        FBase& next = (b >= newBases.Num() || (a < sortedBases.Num() && !less(newBases[b], sortedBases[a]))) ? sortedBases[a++] : newBases[b++];
+        if (!byBase.Contains(next.id))
+            continue;
+        if (merged.Num() && merged.Last().id == next.id)
+            continue;
+        merged.Emplace(MoveTemp(next));
+    }
+    sortedBases = MoveTemp(merged);
+    newBases.Reset();
+    numStaleBases = 0;
+}
+
+int32 FObjectNameIndex::LowerBoundLocked(const FString& s) const
+{
+    int32 lo = 0, hi = sortedBases.Num();
+    while (lo < hi)
+    {
+        int32 mid = (lo + hi) / 2;
+        if (FCString::Stricmp(*sortedBases[mid].name, *s) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void FObjectNameIndex::PrefixCandidatesLocked(const FString& prefix, TArray<int32>& out)
+{
+    SortBasesLocked();
+
+    // every object whose base starts with the prefix
+    for (int32 i = LowerBoundLocked(prefix); i < sortedBases.Num(); i++)
+    {
+        const FBase& base = sortedBases[i];
+        if (FCString::Strnicmp(*base.name, *prefix, prefix.Len()) != 0)
+            break;
+        TArray<int32>* indices = byBase.Find(base.id);
+        if (indices)
+            out.Append(*indices);
+    }
+
+    // and if the prefix runs past the end of a base into a number suffix (e.g. prefix Foo_1 with base Foo), that base too
+    int32 underscore;
+    if (prefix.FindLastChar('_', underscore) && underscore > 0)
+    {
+        bool digits = true;
+        for (int32 i = underscore + 1; i < prefix.Len() && digits; i++)
+            digits = FChar::IsDigit(prefix[i]);
+        FString baseName = prefix.Left(underscore);
+        int32 i = LowerBoundLocked(baseName);
+        if (digits && i < sortedBases.Num() && FCString::Stricmp(*sortedBases[i].name, *baseName) == 0)
+        {
+            TArray<int32>* indices = byBase.Find(sortedBases[i].id);
+            if (indices)
+                out.Append(*indices);
+        }
+    }
+}
+
+void FObjectNameIndex::FilesLocked(const TArray<int32>& candidates, TArray<FName>& filedAs) const
+{
+    filedAs.Reset(candidates.Num());
+    for (int32 index : candidates)
+        filedAs.Emplace(slotNames[index]);
+}
+
+void FObjectNameIndex::Filter(const TArray<int32>& candidates, const TArray<FName>& filedAs, TFunctionRef<bool(UObject*, FName)> match, UObject* within, UClass* klass, TArray<UObject*>& out)
+{
+    TArray<int32> renamed;
+    for (int32 i=0; i < candidates.Num(); i++)
+    {
+        int32 index = candidates[i];
+        FUObjectItem* item = GUObjectArray.IndexToObject(index);
+        UObject* obj = item ? (UObject*)item->Object : nullptr;
+        if (!obj || item->IsPendingKill() || item->IsUnreachable())
+            continue;
+        FName name = obj->GetFName();
+        if (name != filedAs[i])
+            renamed.Emplace(index);
+        if (!match(obj, name))
+            continue;
+        if (klass && !obj->IsA(klass))
+            continue;
+        if (within && !obj->IsIn(within))
+            continue;
+        out.Emplace(obj);
+    }
+
+    if (renamed.Num())
+    {   // re-file anything whose name has changed since we indexed it
+        FScopeLock scope(&lock);
+        for (int32 index : renamed)
+        {
+            FUObjectItem* item = GUObjectArray.IndexToObject(index);
+            FName name = (item && item->Object) ? item->Object->GetFName() : NAME_None;
+            if (slotNames.IsValidIndex(index) && slotNames[index] == name)
+                continue;
+            RemoveLocked(index);
+            AddLocked(index, name);
+        }
+    }
+}
+
+void FObjectNameIndex::FindExact(const FString& name, UObject* within, UClass* klass, TArray<UObject*>& out)
+{
+    FName fname(*name, FNAME_Find);
+    if (fname.IsNone())
+        return; // no object can have a name that isn't in the name table
+    TArray<int32> candidates;
+    TArray<FName> filedAs;
+    {
+        FScopeLock scope(&lock);
+        Start();
+        TArray<int32>* indices = byName.Find(fname);
+        if (indices)
+            candidates = *indices;
+        FilesLocked(candidates, filedAs);
+    }
+    int32 startNum = out.Num();
+    Filter(candidates, filedAs, [&fname](UObject* obj, FName objName) { return objName == fname; }, within, klass, out);
+    if (out.Num() > startNum)
+        return;
+
+    // nothing in the index, but it could be an object that was renamed to this, which the engine's own hash knows about
+    UObject* obj = StaticFindObjectFast(klass ? klass : UObject::StaticClass(), nullptr, fname, false, true, RF_NoFlags, EInternalObjectFlags::PendingKill | EInternalObjectFlags::Unreachable);
+    if (obj && (!within || obj->IsIn(within)))
+    {
+        out.Emplace(obj);
+        int32 index = GUObjectArray.ObjectToIndex(obj);
+        FScopeLock scope(&lock);
+        RemoveLocked(index);
+        AddLocked(index, fname);
+    }
+}
+
+void FObjectNameIndex::FindPrefix(const FString& prefix, UObject* within, UClass* klass, TArray<UObject*>& out)
+{
+    TArray<int32> candidates;
+    TArray<FName> filedAs;
+    {
+        FScopeLock scope(&lock);
+        Start();
+        PrefixCandidatesLocked(prefix, candidates);
+        FilesLocked(candidates, filedAs);
+    }
+    Filter(candidates, filedAs, [&prefix](UObject* obj, FName objName) { return objName.ToString().StartsWith(prefix, ESearchCase::IgnoreCase); }, within, klass, out);
+}
+
+void FObjectNameIndex::FindWildcard(const FString& pattern, UObject* within, UClass* klass, TArray<UObject*>& out)
+{
+    // only names that start with the literal part of the pattern can match
+    int32 literalLen = 0;
+    while (literalLen < pattern.Len() && pattern[literalLen] != '*' && pattern[literalLen] != '?')
+        literalLen++;
+    TArray<int32> candidates;
+    TArray<FName> filedAs;
+    {
+        FScopeLock scope(&lock);
+        Start();
+        PrefixCandidatesLocked(pattern.Left(literalLen), candidates);
+        FilesLocked(candidates, filedAs);
+    }
+    Filter(candidates, filedAs, [&pattern](UObject* obj, FName objName) { return objName.ToString().MatchesWildcard(pattern, ESearchCase::IgnoreCase); }, within, klass, out);
+}
+
+int32 FObjectNameIndex::Num()
+{
+    FScopeLock scope(&lock);
+    return num;
+}
+
+void FObjectNameIndex::NotifyUObjectCreated(const UObjectBase* obj, int32 index)
+{
+    FName name = obj->GetFName();
+    FScopeLock scope(&lock);
+    RemoveLocked(index); // in case we missed the delete of whatever was in this slot before
+    AddLocked(index, name);
+}
+
+void FObjectNameIndex::NotifyUObjectDeleted(const UObjectBase* obj, int32 index)
+{
+    FScopeLock scope(&lock);
+    RemoveLocked(index);
+}
+
+void FObjectNameIndex::OnUObjectArrayShutdown()
+{
+    GUObjectArray.RemoveUObjectCreateListener(this);
+    GUObjectArray.RemoveUObjectDeleteListener(this);
+    listening = false;
+}
+
+int64 UObjectToHandle(UObject* obj)
+{
+    if (!obj)
+        return 0;
+    int32 index = GUObjectArray.ObjectToIndex(obj);
+    int32 serial = GUObjectArray.AllocateSerialNumber(index);
+    return ((int64)index << 32) | (uint32)serial;
+}
+
+UObject* UObjectFromHandle(int64 handle)
+{
+    int32 index = (int32)(handle >> 32);
+    int32 serial = (int32)(handle & 0xffffffff);
+    if (index < 0 || serial == 0)
+        return nullptr;
+    FUObjectItem* item = GUObjectArray.IndexToObject(index);
+    if (!item || item->GetSerialNumber() != serial || item->IsPendingKill() || item->IsUnreachable())
+        return nullptr;
+    return (UObject*)item->Object;
+}
+
+FPyObjectIterator* FPyObjectIterator::FromWeakList(TArray<FWeakObjectPtr>&& objs)
+{
+    int32 pos = 0;
+    return new FPyObjectIterator([objs=MoveTemp(objs), pos]() mutable -> UObject*
+    {
+        while (pos < objs.Num())
+        {
+            UObject* obj = objs[pos++].Get();
+            if (obj)
+                return obj;
+        }
+        return nullptr;
+    });
+}
+
+bool FObjectFilter::Matches(UObject* obj) const
+{
+    if (!obj)
+        return false;
+    if (!klass.IsExplicitlyNull())
+    {
+        UClass* k = klass.Get();
+        if (!k || !obj->IsA(k))
+            return false;
+    }
+    if (!tag.IsNone())
+    {
+        AActor* actor = Cast<AActor>(obj);
+        UActorComponent* comp = actor ? nullptr : Cast<UActorComponent>(obj);
+        if (!(actor && actor->ActorHasTag(tag)) && !(comp && comp->ComponentHasTag(tag)))
+            return false;
+    }
+    if (nameContains.Len() && !obj->GetName().Contains(nameContains))
+        return false;
+    return true;
+}
+
+FObjectFilter FObjectFilter::FromPy(py::object& _klass, py::object& _tag, py::object& _name)
+{
+    FObjectFilter filter;
+    if (!_klass.is_none())
+    {
+        UClass* k = PyObjectToUClass(_klass);
+        if (!k)
+            throw py::type_error("klass must be a class");
+        filter.klass = k;
+    }
+    if (!_tag.is_none())
+        filter.tag = FName(FSTR(_tag.cast<std::string>()));
+    if (!_name.is_none())
+        filter.nameContains = FSTR(_name.cast<std::string>());
+    return filter;
+}
+
+void FObjectSnapshot::TakeAsync(bool includeResourceSize, TFunction<void(FObjectSnapshot*)> onDone)
+{
+    // the quick part: note each object's class (as a handle, so we can safely find it again later)
+    struct FCapture
+    {
+        TArray<int64> classHandles;
+        TArray<int64> sizes;
+        double time;
+        bool hasSizes;
+    };
+    TSharedPtr<FCapture> capture = MakeShared<FCapture>();
+    capture->time = FPlatformTime::Seconds();
+    capture->hasSizes = includeResourceSize;
+    capture->classHandles.Reserve(GUObjectArray.GetObjectArrayNum());
+    TMap<UClass*, int64> classToHandle;
+    for (FRawObjectIterator it; it; ++it)
+    {
+        UObject* obj = (UObject*)((*it)->Object);
+        if (!obj || (*it)->IsPendingKill())
+            continue;
+        UClass* klass = obj->GetClass();
+        int64* handle = classToHandle.Find(klass);
+        capture->classHandles.Emplace(handle ? *handle : classToHandle.Add(klass, UObjectToHandle(klass)));
+        if (includeResourceSize)
+            capture->sizes.Emplace(obj->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+    }
+
+    // the slow part: build the histogram in the background, then come back to the game thread to look up class names
+    Async(EAsyncExecution::ThreadPool, [capture, onDone]()
+    {
+        TMap<int64, FClassStats> byHandle;
+        for (int32 i=0; i < capture->classHandles.Num(); i++)
+        {
+            FClassStats& stats = byHandle.FindOrAdd(capture->classHandles[i]);
+            stats.count++;
+            if (capture->hasSizes)
+                stats.resourceBytes += capture->sizes[i];
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [capture, onDone, byHandle=MoveTemp(byHandle)]()
+        {
+            FObjectSnapshot* snapshot = new FObjectSnapshot();
+            snapshot->time = capture->time;
+            snapshot->totalObjects = capture->classHandles.Num();
+            snapshot->hasResourceSizes = capture->hasSizes;
+            for (auto& entry : byHandle)
+            {
+                UObject* klass = UObjectFromHandle(entry.Key);
+                FString name = klass ? klass->GetPathName() : TEXT("<unloaded class>");
+                FClassStats& stats = snapshot->classes.FindOrAdd(name);
+                stats.count += entry.Value.count;
+                stats.resourceBytes += entry.Value.resourceBytes;
+            }
+            onDone(snapshot);
+        });
+    });
+}
+
+void FObjectSnapshot::WriteCSVAsync(const FString& filename) const
+{
+    TSharedPtr<FObjectSnapshot> copy = MakeShared<FObjectSnapshot>(*this);
+    Async(EAsyncExecution::ThreadPool, [copy, filename]()
+    {
+        FString out;
+        if (!IFileManager::Get().FileExists(*filename))
+            out += TEXT("time,class,count,resourceBytes\n");
+        for (auto& entry : copy->classes)
+            out += FString::Printf(TEXT("%.3f,%s,%d,%lld\n"), copy->time, *entry.Key, entry.Value.count, entry.Value.resourceBytes);
+        if (!FFileHelper::SaveStringToFile(out, *filename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+            LERROR("Failed to write object snapshot to %s", *filename);
+    });
+}
+
@@ -0,0 +1,153 @@
+// Class-indexed registry of live UObjects, so that "give me all the objects of class X" doesn't have to walk every UObject
+// in the process. Nothing is tracked until someone asks about a class: the first query for a class does one full scan to
+// seed it, and from then on the registry keeps that class's instances (including instances of subclasses, e.g. Python
+// subclasses made via RegisterPythonSubclass) up to date by listening to UObject creation and deletion.
+//
+// Also has FPyObjectIterator, a Python iterator that produces UObjects one at a time, so that enumeration APIs don't have
+// to create a Python wrapper for every object up front.
+
+#pragma once
+
+#include "uepy.h"
+#include "UObject/UObjectArray.h"
+
+class FObjectRegistry : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+{
+    struct FTrackedClass
+    {
+        TWeakObjectPtr<UClass> klass;
+        TSet<int32> indices; // GUObjectArray indices of live instances
+    };
+
+    FCriticalSection lock; // objects can be created and deleted from other threads (e.g. async loading)
+    TArray<FTrackedClass> tracked;
+    TMap<const UClass*, TArray<int32>> classToTracked; // cache: class --> which entries in tracked its instances go in
+    FDelegateHandle postGCHandle;
+    bool listening = false;
+
+    int32 Track(UClass* klass); // returns the index into tracked
+    const TArray<int32>& GetTrackedFor(const UClass* klass); // caller must hold lock
+
+public:
+    static FObjectRegistry& Get();
+
+    // appends a weak ref to each live (and not pending kill) instance of klass, optionally just those in the given world
+    void GetObjects(UClass* klass, UWorld* world, TArray<FWeakObjectPtr>& out);
+    int32 NumTrackedClasses();
+
+    // FUObjectCreateListener/FUObjectDeleteListener
+    virtual void NotifyUObjectCreated(const UObjectBase* obj, int32 index) override;
+    virtual void NotifyUObjectDeleted(const UObjectBase* obj, int32 index) override;
+    virtual void OnUObjectArrayShutdown() override;
+};
+
+// Index of UObjects by name, for name lookups that don't have to look at every object in the process. Like the registry,
+// it doesn't exist until first used (at which point it does one full scan), and from then on it's kept up to date by the
+// UObject creation/deletion listeners. Objects are filed by their full FName (so an exact lookup is one hash probe) and
+// by their FName's base (the name minus any number suffix), and the distinct base names are also kept as a
+// case-insensitively sorted array, so a prefix lookup is a binary search plus a scan of just the bases that start with the
+// prefix. Wildcard lookups do the same using the literal part of the pattern before the first * or ?. Keeping the index up
+// to date is a couple of hash lookups per object; a base name string is only made the first time that base is seen.
+// Scoping to a package or world (or any other outer) is done via the engine's outer chain, and if you want all objects
+// directly in some outer, the engine already has an index for that (GetObjectsWithOuter).
+// The engine has no notification for renames, so objects renamed after they were created are re-filed when a lookup
+// comes across them under their old name. An exact lookup that finds nothing in the index also checks the engine's own
+// name hash, which does know about renames, so it can still find a renamed object (though just one).
+class FObjectNameIndex : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+{
+    struct FBase
+    {
+        FString name;
+        FNameEntryId id;
+    };
+
+    FCriticalSection lock;
+    TMap<FName, TArray<int32>> byName; // full name --> GUObjectArray indices
+    TMap<FNameEntryId, TArray<int32>> byBase; // base name (comparison index) --> GUObjectArray indices
+    TArray<FBase> sortedBases; // case-insensitive order; may have entries for bases that have since gone away
+    TArray<FBase> newBases; // bases seen since sortedBases was last brought up to date, in no particular order
+    int32 numStaleBases = 0; // entries in sortedBases whose base has gone away
+    TArray<FName> slotNames; // GUObjectArray index --> what it's filed under (NAME_None if nothing)
+    int32 num = 0;
+    bool listening = false;
+
+    void Start(); // caller must hold lock
+    void AddLocked(int32 index, FName name);
+    void RemoveLocked(int32 index);
+    void SortBasesLocked(); // merges newBases into sortedBases and drops stale entries, if needed
+    int32 LowerBoundLocked(const FString& s) const; // first entry in sortedBases that isn't less than s
+
+    // appends the indices of objects whose names could start with prefix
+    void PrefixCandidatesLocked(const FString& prefix, TArray<int32>& out);
+
+    void FilesLocked(const TArray<int32>& candidates, TArray<FName>& filedAs) const; // what each candidate is filed under
+
+    // calls match(obj, objName) on each candidate object and adds those that match and pass the within/klass filters to
+    // out. Candidates whose names no longer match what they were filed as (per filedAs) get re-filed.
+    void Filter(const TArray<int32>& candidates, const TArray<FName>& filedAs, TFunctionRef<bool(UObject*, FName)> match, UObject* within, UClass* klass, TArray<UObject*>& out);
+
+public:
+    static FObjectNameIndex& Get();
+
+    void FindExact(const FString& name, UObject* within, UClass* klass, TArray<UObject*>& out);
+    void FindPrefix(const FString& prefix, UObject* within, UClass* klass, TArray<UObject*>& out);
+    void FindWildcard(const FString& pattern, UObject* within, UClass* klass, TArray<UObject*>& out); // * and ? wildcards
+    int32 Num();
+
+    virtual void NotifyUObjectCreated(const UObjectBase* obj, int32 index) override;
+    virtual void NotifyUObjectDeleted(const UObjectBase* obj, int32 index) override;
+    virtual void OnUObjectArrayShutdown() override;
+};
+
+// Population statistics for all UObjects in the process, for tracking down object leaks over long sessions: for each class,
+// how many instances there are and (optionally) their total resource size. Only the capture happens on the game thread, and
+// all it does is record the class of every object (plus its resource size if asked, which is a lot slower); building the
+// histogram and writing CSVs happen on worker threads.
+struct FObjectSnapshot
+{
+    struct FClassStats
+    {
+        int32 count = 0;
+        int64 resourceBytes = 0;
+    };
+
+    double time = 0; // FPlatformTime::Seconds when captured
+    int32 totalObjects = 0;
+    bool hasResourceSizes = false;
+    TMap<FString, FClassStats> classes; // class name --> stats
+
+    // captures the object list and then builds the snapshot in the background. onDone is called on the game thread.
+    static void TakeAsync(bool includeResourceSize, TFunction<void(FObjectSnapshot*)> onDone);
+
+    // appends one row per class (time, class, count, resourceBytes) to the given file, from a worker thread. The header
+    // row is written only if the file doesn't exist yet, so repeated calls build up a single file for trend tracking.
+    void WriteCSVAsync(const FString& filename) const;
+};
+
+// Object handles: a GUObjectArray index and serial number packed into an int64, so a whole set of objects can be handed to
+// Python as a buffer and resolved later (to nullptr if the object has since gone away).
+int64 UObjectToHandle(UObject* obj);
+UObject* UObjectFromHandle(int64 handle);
+
+// A Python iterator over UObjects. next() returns the next object or nullptr when done; wrappers are created only for the
+// objects that are actually yielded, so breaking out of a loop early doesn't pay for the rest.
+struct FPyObjectIterator
+{
+    TUniqueFunction<UObject*()> next;
+
+    FPyObjectIterator(TUniqueFunction<UObject*()>&& _next) : next(MoveTemp(_next)) {}
+    static FPyObjectIterator* FromWeakList(TArray<FWeakObjectPtr>&& objs); // skips any that have gone away by the time they are reached
+};
+
+// Optional predicates for the Iter* enumeration APIs. They are checked in C++ so objects that don't match never make it
+// to Python at all.
+struct FObjectFilter
+{
+    TWeakObjectPtr<UClass> klass; // if set, objects must be of this class
+    FName tag; // if set, objects must be actors or components with this tag
+    FString nameContains; // if set, object names must contain this
+
+    bool Matches(UObject* obj) const;
+    static FObjectFilter FromPy(py::object& klass, py::object& tag, py::object& name); // any can be None
+};
+
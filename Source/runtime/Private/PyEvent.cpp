@@ -0,0 +1,191 @@
+#include "PyEvent.h"
+#include "common.h"
+#include "Engine/World.h"
+
+// Events don't fire unless the current world is ok. That's the first Game world, else PIE, else Editor - same as
+// uepy.GetWorld. Picking it means a walk over all the UWorlds, so the pick is cached and redone only after a world has been
+// initialized or cleaned up (or the picked one has gone away), while whether it has started tearing down is checked on
+// every fire, since that can happen at any point in a frame.
+static TWeakObjectPtr<UWorld> eventWorld;
+static bool eventWorldStale = true;
+
+static void _PickEventWorld()
+{
+    UWorld* game = nullptr;
+    UWorld* pie = nullptr;
+    UWorld* editor = nullptr;
+    for (TObjectIterator<UWorld> it; it; ++it)
+    {
+        UWorld* w = *it;
+        if (w->WorldType == EWorldType::Game && !game)
+            game = w;
+        else if (w->WorldType == EWorldType::PIE && !pie)
+            pie = w;
+        else if (w->WorldType == EWorldType::Editor && !editor)
+            editor = w;
+    }
+    eventWorld = game ? game : (pie ? pie : editor);
+    eventWorldStale = false;
+}
+
+static bool _EventWorldOK()
+{
+    static bool hooked = false;
+    if (!hooked)
+    {
+        hooked = true;
+        FWorldDelegates::OnPostWorldInitialization.AddLambda([](UWorld*, const UWorld::InitializationValues) { eventWorldStale = true; });
+        FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld*, bool, bool) { eventWorldStale = true; });
+    }
+    if (eventWorldStale || !eventWorld.IsValid())
+        _PickEventWorld();
+    UWorld* world = eventWorld.Get();
+    return world && !world->bIsTearingDown;
+}
+
+// while one of these exists, dead listeners stay in the list (so indices don't shift under a loop over it); the last one
+// to go away compacts the list, even if it's going away because of an exception
+struct FPyEvent::FFiringScope
+{
+    FPyEvent& event;
+    FFiringScope(FPyEvent& _event) : event(_event) { event.firingDepth++; }
+    ~FFiringScope()
+    {
+        if (--event.firingDepth == 0)
+            event.Compact();
+    }
+};
+
+void FPyEvent::Add(py::object& method)
+{
+    if (!PyMethod_Check(method.ptr()))
+        throw py::type_error("Event callbacks must be bound methods");
+    py::object owner = py::reinterpret_borrow<py::object>(PyMethod_GET_SELF(method.ptr()));
+    FListener l;
+    l.ownerRef = py::weakref(owner);
+    l.func = py::reinterpret_borrow<py::object>(PyMethod_GET_FUNCTION(method.ptr()));
+    l.hasEngineObj = py::hasattr(owner, "engineObj");
+    listeners.Emplace(MoveTemp(l));
+}
+
+void FPyEvent::Kill(FListener& l)
+{
+    if (l.dead)
+        return;
+    l.dead = true;
+    numDead++;
+    if (firingDepth == 0)
+        Compact();
+}
+
+void FPyEvent::Compact()
+{
+    if (numDead == 0)
+        return;
+    listeners.RemoveAll([](const FListener& l) { return l.dead; });
+    numDead = 0;
+}
+
+bool FPyEvent::Remove(py::object& method)
+{
+    if (!PyMethod_Check(method.ptr()))
+        return false;
+    PyObject* owner = PyMethod_GET_SELF(method.ptr());
+    PyObject* func = PyMethod_GET_FUNCTION(method.ptr());
+    for (FListener& l : listeners)
+    {
+        if (!l.dead && l.func.ptr() == func && PyWeakref_GetObject(l.ownerRef.ptr()) == owner)
+        {
+            Kill(l);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FPyEvent::RemoveOn(py::object& owner)
+{
+    FFiringScope scope(*this); // so the list doesn't shift under us
+    for (FListener& l : listeners)
+    {
+        PyObject* o = PyWeakref_GetObject(l.ownerRef.ptr());
+        if (o == Py_None || o == owner.ptr())
+            Kill(l); // also tosses any listeners whose owners are gone
+    }
+}
+
+void FPyEvent::RemoveAll()
+{
+    FFiringScope scope(*this);
+    for (FListener& l : listeners)
+        Kill(l);
+}
+
+void FPyEvent::Fire(py::args& args, py::kwargs& kwargs)
+{
+    if (!IsInGameThread() && !IsInSlateThread())
+    {
+        FString callers = TEXT("?");
+        try {
+            callers = FSTR(py::module::import("uepy").attr("Callers")().cast<std::string>());
+        } catchpy;
+        LERROR("Event firing from wrong thread: %s", *callers);
+    }
+    if (!_EventWorldOK())
+        return;
+
+    double start = FPlatformTime::Seconds();
+    fireCount++;
+    FFiringScope scope(*this);
+    PyObject* kw = py::len(kwargs) > 0 ? kwargs.ptr() : nullptr;
+    int32 count = listeners.Num(); // anything added by a callback waits until the next fire
+    for (int32 i=0; i < count; i++)
+    {
+        if (listeners[i].dead)
+            continue;
+        PyObject* owner = PyWeakref_GetObject(listeners[i].ownerRef.ptr());
+        if (owner == Py_None)
+        {
+            Kill(listeners[i]);
+            continue;
+        }
+
+        // Special case: if the owner of the callback is a Python wrapper for an engine object, it's possible that the
+        // underlying engine object is no longer valid, but the engine hasn't run GC yet, so the Python object still exists,
+        // so we need to detect that scenario and not call the callback.
+        py::object ownerObj = py::reinterpret_borrow<py::object>(owner);
+        if (listeners[i].hasEngineObj)
+        {
+            py::object engineObj = ownerObj.attr("engineObj");
+            UObject* uobj = py::isinstance<UObject>(engineObj) ? engineObj.cast<UObject*>() : nullptr;
+            if (!engineObj.is_none() && (!uobj || !uobj->IsValidLowLevel() || uobj->IsPendingKillOrUnreachable()))
+            {
+                LWARN("skipping callback to %s because engine obj is no longer valid", REPR(ownerObj));
+                Kill(listeners[i]);
+                continue;
+            }
+        }
+
+        // listeners can get reallocated during the call, so hold our own refs
+        py::object bound = py::reinterpret_steal<py::object>(PyMethod_New(listeners[i].func.ptr(), owner));
+        try {
+            PyObject* ret = PyObject_Call(bound.ptr(), args.ptr(), kw);
+            if (!ret)
+                throw py::error_already_set();
+            Py_DECREF(ret);
+        } catchpy;
+    }
+    fireSeconds += FPlatformTime::Seconds() - start;
+}
+
+py::list FPyEvent::GetCallbacks()
+{
+    py::list ret;
+    for (FListener& l : listeners)
+    {
+        PyObject* owner = PyWeakref_GetObject(l.ownerRef.ptr());
+        if (!l.dead && owner != Py_None)
+            ret.append(py::reinterpret_steal<py::object>(PyMethod_New(l.func.ptr(), owner)));
+    }
+    return ret;
+}
@@ -0,0 +1,43 @@
+// Native side of uepy.Event, the local publish/subscribe helper. Listeners are bound methods held weakly: a weakref to the
+// owning object plus the underlying function, so firing never goes through weakref.WeakMethod (which is implemented in
+// Python), and dead listeners are pruned as they're found.
+//
+// Listeners can be added and removed while the event is firing (including from inside a callback) without the listener list
+// being copied on every fire: removed entries are just marked dead until the outermost Fire finishes, and entries added
+// during a fire aren't called until the next one.
+
+#pragma once
+
+#include "uepy.h"
+
+class FPyEvent
+{
+    struct FListener
+    {
+        py::object ownerRef; // weakref to the method's __self__
+        py::object func; // the method's __func__
+        bool hasEngineObj = false; // true if the owner is a Python wrapper for an engine object (it has an engineObj attr)
+        bool dead = false;
+    };
+
+    TArray<FListener> listeners;
+    int32 firingDepth = 0; // managed by FFiringScope
+    int32 numDead = 0;
+    struct FFiringScope;
+
+    void Compact();
+    void Kill(FListener& l);
+
+public:
+    // stats
+    int64 fireCount = 0;
+    double fireSeconds = 0; // total time spent in Fire, including callbacks
+
+    void Add(py::object& method); // raises TypeError if it's not a bound method
+    bool Remove(py::object& method); // false if it wasn't found
+    void RemoveOn(py::object& owner);
+    void RemoveAll();
+    void Fire(py::args& args, py::kwargs& kwargs);
+    py::list GetCallbacks(); // the live listeners, as bound methods
+    int32 Num() const { return listeners.Num() - numDead; }
+};
@@ -0,0 +1,97 @@
+#include "PyForward.h"
+#include "common.h"
+#include "structmember.h"
+
+struct FPyForward
+{
+    PyObject_HEAD
+    PyObject* name; // interned method name
+    bool returns;
+};
+
+static PyObject* engineObjStr = nullptr;
+
+static void _ForwardDealloc(PyObject* self)
+{
+    Py_XDECREF(((FPyForward*)self)->name);
+    Py_TYPE(self)->tp_free(self);
+}
+
+// called with (inst, *args) - either via the bound method that _ForwardGet returns, or directly via the class
+static PyObject* _ForwardCall(PyObject* self, PyObject* args, PyObject* kwargs)
+{
+    FPyForward* f = (FPyForward*)self;
+    Py_ssize_t numArgs = PyTuple_GET_SIZE(args);
+    if (numArgs < 1)
+    {
+        PyErr_Format(PyExc_TypeError, "%U() needs an instance as its first argument", f->name);
+        return nullptr;
+    }
+    PyObject* engineObj = PyObject_GetAttr(PyTuple_GET_ITEM(args, 0), engineObjStr);
+    if (!engineObj)
+        return nullptr;
+    PyObject* method = PyObject_GetAttr(engineObj, f->name);
+    Py_DECREF(engineObj);
+    if (!method)
+        return nullptr;
+    PyObject* rest = PyTuple_GetSlice(args, 1, numArgs);
+    PyObject* ret = rest ? PyObject_Call(method, rest, kwargs) : nullptr;
+    Py_XDECREF(rest);
+    Py_DECREF(method);
+    if (ret && !f->returns)
+    {
+        Py_DECREF(ret);
+        Py_RETURN_NONE;
+    }
+    return ret;
+}
+
+// like a function: accessed via an instance it's a bound method, accessed via the class it's itself
+static PyObject* _ForwardGet(PyObject* self, PyObject* inst, PyObject* owner)
+{
+    if (!inst || inst == Py_None)
+    {
+        Py_INCREF(self);
+        return self;
+    }
+    return PyMethod_New(self, inst);
+}
+
+static PyObject* _ForwardRepr(PyObject* self)
+{
+    return PyUnicode_FromFormat("<forward to engineObj.%U>", ((FPyForward*)self)->name);
+}
+
+static PyMemberDef forwardMembers[] = {
+    {(char*)"__name__", T_OBJECT, offsetof(FPyForward, name), READONLY, nullptr},
+    {nullptr}
+};
+
+static PyTypeObject forwardType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+
+py::object MakePyForward(const std::string& name, bool returns)
+{
+    if (!engineObjStr)
+    {
+        engineObjStr = PyUnicode_InternFromString("engineObj");
+        forwardType.tp_name = "_uepy.Forward";
+        forwardType.tp_basicsize = sizeof(FPyForward);
+        forwardType.tp_flags = Py_TPFLAGS_DEFAULT;
+        forwardType.tp_doc = "Forwards calls to the method of the same name on the instance's engineObj (see uepy.FORWARDS)";
+        forwardType.tp_dealloc = _ForwardDealloc;
+        forwardType.tp_call = _ForwardCall;
+        forwardType.tp_descr_get = _ForwardGet;
+        forwardType.tp_repr = _ForwardRepr;
+        forwardType.tp_members = forwardMembers;
+        forwardType.tp_alloc = PyType_GenericAlloc;
+        if (PyType_Ready(&forwardType) < 0)
+            throw py::error_already_set();
+    }
+
+    FPyForward* f = (FPyForward*)forwardType.tp_alloc(&forwardType, 0);
+    if (!f)
+        throw py::error_already_set();
+    f->name = PyUnicode_InternFromString(name.c_str());
+    f->returns = returns;
+    return py::reinterpret_steal<py::object>((PyObject*)f);
+}
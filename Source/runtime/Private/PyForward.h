@@ -0,0 +1,15 @@
+// Native side of uepy.FORWARDS: a method descriptor that forwards calls on a PGLUE instance straight to the method of the
+// same name on its engineObj. It's a plain CPython type rather than a pybind11 class so that a forwarded call costs about
+// as much as calling the engine binding directly: no Python frame of its own and no pybind11 argument dispatch.
+//
+// It's a non-data descriptor that behaves like a function: inst.Method is a real bound method whose __self__ is the PGLUE
+// instance (so it works with Event.Add, Event.UnbindOn, etc.), cls.Method(inst, ...) works, and subclasses and
+// instances can override it.
+
+#pragma once
+
+#include "uepy.h"
+
+// returns a new forwarder for the given method name. If returns is false, calls return None no matter what the engine
+// method returns (for setters whose handwritten wrappers didn't return anything).
+py::object MakePyForward(const std::string& name, bool returns);
@@ -0,0 +1,343 @@
+#include "SpatialIndex.h"
+#include "common.h"
+
+static TMap<FName, TUniquePtr<FSpatialIndex>> allIndices;
+
+FSpatialIndex* FSpatialIndex::Get(FName name, float cellSize)
+{
+    TUniquePtr<FSpatialIndex>* existing = allIndices.Find(name);
+    if (existing)
+        return existing->Get();
+    FSpatialIndex* index = new FSpatialIndex(name, cellSize);
+    allIndices.Add(name, TUniquePtr<FSpatialIndex>(index));
+    return index;
+}
+
+TArray<FSpatialIndex*> FSpatialIndex::GetAll()
+{
+    TArray<FSpatialIndex*> ret;
+    for (auto& entry : allIndices)
+        ret.Emplace(entry.Value.Get());
+    return ret;
+}
+
+FSpatialIndex::FSpatialIndex(FName _name, float _cellSize) : cellSize(FMath::Max(_cellSize, 1.0f)), name(_name)
+{
+    Clear();
+}
+
+FSpatialIndex::~FSpatialIndex()
+{
+    Clear();
+}
+
+FIntVector FSpatialIndex::CellFor(const FVector& loc) const
+{
+    // clamped so that huge query ranges (e.g. an unbounded kNN search) don't overflow
+    const float limit = 1e9f;
+    return FIntVector(FMath::FloorToInt(FMath::Clamp(loc.X / cellSize, -limit, limit)),
+                      FMath::FloorToInt(FMath::Clamp(loc.Y / cellSize, -limit, limit)),
+                      FMath::FloorToInt(FMath::Clamp(loc.Z / cellSize, -limit, limit)));
+}
+
+void FSpatialIndex::Unbind(Entry& e)
+{
+    USceneComponent* root = e.root.Get();
+    if (root && e.moveHandle.IsValid())
+        root->TransformUpdated.Remove(e.moveHandle);
+    e.moveHandle.Reset();
+}
+
+void FSpatialIndex::AddToCell(int32 id, const FIntVector& cell)
+{
+    cells.FindOrAdd(cell).Emplace(id);
+    GrowOccupied(cell);
+}
+
+void FSpatialIndex::GrowOccupied(const FIntVector& cell)
+{
+    minOccupied = FIntVector(FMath::Min(minOccupied.X, cell.X), FMath::Min(minOccupied.Y, cell.Y), FMath::Min(minOccupied.Z, cell.Z));
+    maxOccupied = FIntVector(FMath::Max(maxOccupied.X, cell.X), FMath::Max(maxOccupied.Y, cell.Y), FMath::Max(maxOccupied.Z, cell.Z));
+}
+
+int32 FSpatialIndex::Add(AActor* actor)
+{
+    if (!IsValid(actor))
+        return -1;
+    FObjectKey key(actor);
+    int32* existing = actorToID.Find(key);
+    if (existing)
+        return *existing;
+
+    Entry e;
+    e.actor = actor;
+    e.key = key;
+    e.root = actor->GetRootComponent();
+    e.loc = actor->GetActorLocation();
+    e.cell = CellFor(e.loc);
+    int32 id = entries.Add(e);
+    actorToID.Add(key, id);
+    AddToCell(id, e.cell);
+
+    USceneComponent* root = actor->GetRootComponent();
+    if (root)
+    {
+        entries[id].moveHandle = root->TransformUpdated.AddLambda([this, id](USceneComponent* comp, EUpdateTransformFlags flags, ETeleportType teleport)
+        {
+            Update(id, comp->GetComponentLocation());
+        });
+    }
+    return id;
+}
+
+void FSpatialIndex::Remove(AActor* actor)
+{
+    const int32* id = actor ? actorToID.Find(FObjectKey(actor)) : nullptr;
+    if (id)
+        RemoveID(*id);
+}
+
+void FSpatialIndex::RemoveID(int32 id)
+{
+    Entry& e = entries[id];
+    actorToID.Remove(e.key);
+    Unbind(e);
+    TArray<int32>* cell = cells.Find(e.cell);
+    if (cell)
+    {
+        cell->RemoveSwap(id);
+        if (cell->Num() == 0)
+            cells.Remove(e.cell);
+    }
+    entries.RemoveAt(id);
+}
+
+void FSpatialIndex::Update(int32 id, const FVector& loc)
+{
+    if (!entries.IsValidIndex(id))
+        return;
+    Entry& e = entries[id];
+    e.loc = loc;
+    FIntVector newCell = CellFor(loc);
+    if (newCell == e.cell)
+        return; // the common case: the actor moved but stayed in the same cell
+
+    TArray<int32>* oldCell = cells.Find(e.cell);
+    if (oldCell)
+    {
+        oldCell->RemoveSwap(id);
+        if (oldCell->Num() == 0)
+            cells.Remove(e.cell);
+    }
+    e.cell = newCell;
+    AddToCell(id, newCell);
+}
+
+void FSpatialIndex::Refresh()
+{
+    TArray<int32> dead;
+    for (auto it = entries.CreateIterator(); it; ++it)
+    {
+        AActor* actor = it->actor.Get();
+        if (!IsValid(actor) || actor->IsPendingKillOrUnreachable())
+            dead.Emplace(it.GetIndex());
+        else
+            Update(it.GetIndex(), actor->GetActorLocation());
+    }
+    for (int32 id : dead)
+        RemoveID(id);
+
+    // recompute the occupied range now that things have settled
+    minOccupied = FIntVector(MAX_int32);
+    maxOccupied = FIntVector(MIN_int32);
+    for (auto& pair : cells)
+        GrowOccupied(pair.Key);
+}
+
+void FSpatialIndex::Clear()
+{
+    for (Entry& e : entries)
+        Unbind(e);
+    entries.Empty();
+    actorToID.Empty();
+    cells.Empty();
+    minOccupied = FIntVector(MAX_int32);
+    maxOccupied = FIntVector(MIN_int32);
+}
+
+AActor* FSpatialIndex::GetActor(int32 id) const
+{
+    if (!entries.IsValidIndex(id))
+        return nullptr;
+    return entries[id].actor.Get();
+}
+
+int32 FSpatialIndex::GetID(AActor* actor) const
+{
+    const int32* id = actor ? actorToID.Find(FObjectKey(actor)) : nullptr;
+    return id ? *id : -1;
+}
+
+template<typename F>
+void FSpatialIndex::ForEachCell(const FIntVector& minCell, const FIntVector& maxCell, F func) const
+{
+    // for big ranges it's cheaper to walk the occupied cells than to probe every cell in the range
+    double rangeSize = ((double)maxCell.X - minCell.X + 1) * ((double)maxCell.Y - minCell.Y + 1) * ((double)maxCell.Z - minCell.Z + 1);
+    if (rangeSize > cells.Num())
+    {
+        for (auto& pair : cells)
+        {
+            const FIntVector& c = pair.Key;
+            if (c.X >= minCell.X && c.X <= maxCell.X && c.Y >= minCell.Y && c.Y <= maxCell.Y && c.Z >= minCell.Z && c.Z <= maxCell.Z)
+                func(c, pair.Value);
+        }
+        return;
+    }
+
+    for (int32 x=minCell.X; x <= maxCell.X; x++)
+        for (int32 y=minCell.Y; y <= maxCell.Y; y++)
+            for (int32 z=minCell.Z; z <= maxCell.Z; z++)
+            {
+                FIntVector c(x,y,z);
+                const TArray<int32>* cell = cells.Find(c);
+                if (cell)
+                    func(c, *cell);
+            }
+}
+
+void FSpatialIndex::QueryRadius(const FVector& center, float radius, TArray<int32>& out) const
+{
+    float radiusSq = radius * radius;
+    ForEachCell(CellFor(center - FVector(radius)), CellFor(center + FVector(radius)), [&](const FIntVector& c, const TArray<int32>& cell)
+    {
+        for (int32 id : cell)
+            if (FVector::DistSquared(entries[id].loc, center) <= radiusSq)
+                out.Emplace(id);
+    });
+}
+
+void FSpatialIndex::QueryBox(const FBox& box, TArray<int32>& out) const
+{
+    ForEachCell(CellFor(box.Min), CellFor(box.Max), [&](const FIntVector& c, const TArray<int32>& cell)
+    {
+        for (int32 id : cell)
+            if (box.IsInsideOrOn(entries[id].loc))
+                out.Emplace(id);
+    });
+}
+
+void FSpatialIndex::QueryKNearest(const FVector& center, int32 k, float maxRadius, TArray<int32>& out) const
+{
+    if (k <= 0 || entries.Num() == 0)
+        return;
+
+    // grow the search radius until we have at least k candidates (or hit the max), then keep the k closest. Once we
+    // have k candidates within radius r, the true k nearest are guaranteed to be among them.
+    TArray<int32> candidates;
+    float radius = cellSize;
+    while (true)
+    {
+        candidates.Reset();
+        float r = FMath::Min(radius, maxRadius);
+        QueryRadius(center, r, candidates);
+        if (candidates.Num() >= k || r >= maxRadius || candidates.Num() == entries.Num())
+            break;
+        radius *= 2;
+    }
+
+    candidates.Sort([this, &center](int32 a, int32 b) { return FVector::DistSquared(entries[a].loc, center) < FVector::DistSquared(entries[b].loc, center); });
+    out.Append(candidates.GetData(), FMath::Min(k, candidates.Num()));
+}
+
+// true if the volume (with outward facing planes) is bounded, i.e. there's no direction you can go forever and stay
+// inside. That's the case unless some direction is on the inside of every plane, and if there is such a direction then
+// one lies along the intersection of two of the planes.
+static bool _IsBounded(const FConvexVolume& volume)
+{
+    const TArray<FPlane>& planes = volume.Planes;
+    if (planes.Num() < 4)
+        return false;
+    for (int32 i=0; i < planes.Num(); i++)
+        for (int32 j=i+1; j < planes.Num(); j++)
+        {
+            FVector dir = FVector::CrossProduct(planes[i], planes[j]);
+            if (dir.IsNearlyZero())
+                continue;
+            for (float sign : {1.0f, -1.0f})
+            {
+                bool escapes = true;
+                for (const FPlane& p : planes)
+                    if (FVector::DotProduct(p, dir * sign) > KINDA_SMALL_NUMBER)
+                    {
+                        escapes = false;
+                        break;
+                    }
+                if (escapes)
+                    return false;
+            }
+        }
+    return true;
+}
+
+// bounding box of a bounded convex volume, from the corners where three of its planes meet
+static FBox _VolumeBounds(const FConvexVolume& volume)
+{
+    const TArray<FPlane>& planes = volume.Planes;
+    FBox bounds(ForceInit);
+    for (int32 i=0; i < planes.Num(); i++)
+        for (int32 j=i+1; j < planes.Num(); j++)
+            for (int32 k=j+1; k < planes.Num(); k++)
+            {
+                FVector corner;
+                if (!FMath::IntersectPlanes3(corner, planes[i], planes[j], planes[k]))
+                    continue;
+                bool inside = true;
+                for (const FPlane& p : planes)
+                    if (p.PlaneDot(corner) > 1.0f) // generous, since corners are right on the planes
+                    {
+                        inside = false;
+                        break;
+                    }
+                if (inside)
+                    bounds += corner;
+            }
+    return bounds;
+}
+
+void FSpatialIndex::QueryFrustum(const FConvexVolume& frustum, float radius, TArray<int32>& out) const
+{
+    if (cells.Num() == 0)
+        return;
+
+    // walk the cells in the frustum's bounds (or, if it has no far plane, everything that's occupied), skipping whole
+    // cells that are outside of it and taking whole cells that are completely inside of it
+    FIntVector minCell = minOccupied, maxCell = maxOccupied;
+    if (_IsBounded(frustum))
+    {
+        FBox bounds = _VolumeBounds(frustum);
+        if (!bounds.IsValid)
+            return;
+        FIntVector lo = CellFor(bounds.Min - FVector(radius)), hi = CellFor(bounds.Max + FVector(radius));
+        minCell = FIntVector(FMath::Max(minCell.X, lo.X), FMath::Max(minCell.Y, lo.Y), FMath::Max(minCell.Z, lo.Z));
+        maxCell = FIntVector(FMath::Min(maxCell.X, hi.X), FMath::Min(maxCell.Y, hi.Y), FMath::Min(maxCell.Z, hi.Z));
+        if (minCell.X > maxCell.X || minCell.Y > maxCell.Y || minCell.Z > maxCell.Z)
+            return;
+    }
+
+    FVector halfCell(cellSize * 0.5f);
+    ForEachCell(minCell, maxCell, [&](const FIntVector& c, const TArray<int32>& cell)
+    {
+        FVector center = FVector(c) * cellSize + halfCell;
+        if (!frustum.IntersectBox(center, halfCell + FVector(radius)))
+            return;
+        bool fullyInside = false;
+        if (frustum.IntersectBox(center, halfCell, fullyInside) && fullyInside)
+        {
+            out.Append(cell);
+            return;
+        }
+        for (int32 id : cell)
+            if (frustum.IntersectSphere(entries[id].loc, radius))
+                out.Emplace(id);
+    });
+}
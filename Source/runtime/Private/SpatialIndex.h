@@ -0,0 +1,65 @@
+// uniform grid spatial index over actors, for fast proximity queries from Python without having to walk every actor
+// of some class and compute distances in Python. Actors join an index explicitly (Python glue classes can do it
+// automatically - see AActor_PGLUE.spatialIndex) and their positions are kept up to date by listening to their root
+// component's TransformUpdated event, so there's no per-frame polling.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ConvexVolume.h"
+#include "GameFramework/Actor.h"
+#include "UObject/ObjectKey.h"
+
+class FSpatialIndex
+{
+    struct Entry
+    {
+        TWeakObjectPtr<AActor> actor;
+        FObjectKey key; // what's in actorToID
+        TWeakObjectPtr<USceneComponent> root; // the comp whose TransformUpdated we're bound to
+        FDelegateHandle moveHandle;
+        FVector loc;
+        FIntVector cell;
+    };
+
+    float cellSize;
+    TSparseArray<Entry> entries; // an entry's index in here is its id
+    TMap<FObjectKey, int32> actorToID; // not keyed by AActor* so that a new actor at a dead one's address can't alias it
+    TMap<FIntVector, TArray<int32>> cells; // cell coords --> ids of the entries in that cell
+    FIntVector minOccupied, maxOccupied; // range of cells that have (or have had) entries; only shrinks on Refresh/Clear
+
+    FIntVector CellFor(const FVector& loc) const;
+    void Unbind(Entry& e);
+    void RemoveID(int32 id);
+    void AddToCell(int32 id, const FIntVector& cell);
+    void GrowOccupied(const FIntVector& cell);
+    template<typename F> void ForEachCell(const FIntVector& minCell, const FIntVector& maxCell, F func) const;
+
+public:
+    FName name;
+
+    FSpatialIndex(FName _name, float _cellSize);
+    ~FSpatialIndex();
+
+    // named, process-wide indices. cellSize is only used if the index doesn't exist yet.
+    static FSpatialIndex* Get(FName name, float cellSize);
+    static TArray<FSpatialIndex*> GetAll();
+
+    int32 Add(AActor* actor); // returns the entry id (adding an actor more than once is harmless)
+    void Remove(AActor* actor);
+    void Update(int32 id, const FVector& loc);
+    void Refresh(); // re-reads the location of every actor and drops any that have gone away
+    void Clear();
+    int32 Num() const { return entries.Num(); }
+    float GetCellSize() const { return cellSize; }
+    AActor* GetActor(int32 id) const; // nullptr if the id is bad or the actor is gone
+    int32 GetID(AActor* actor) const; // -1 if not in the index
+
+    // queries append entry ids to out. None of them touch any UObjects, so it is safe to run them on other threads
+    // as long as the index isn't being modified at the same time.
+    void QueryRadius(const FVector& center, float radius, TArray<int32>& out) const;
+    void QueryBox(const FBox& box, TArray<int32>& out) const;
+    void QueryKNearest(const FVector& center, int32 k, float maxRadius, TArray<int32>& out) const; // closest first
+    void QueryFrustum(const FConvexVolume& frustum, float radius, TArray<int32>& out) const;
+};
+
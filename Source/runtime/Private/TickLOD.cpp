@@ -0,0 +1,202 @@
+#include "TickLOD.h"
+#include "common.h"
+#include "uepy_kernels.h"
+#include "GameFramework/PlayerController.h"
+
+FTickLODManager& FTickLODManager::Get()
+{
+    static FTickLODManager* manager = new FTickLODManager(); // leaked on purpose: it holds a py::object (the scorer), which can't be released after Python has shut down
+    return *manager;
+}
+
+FTickLODManager::FTickLODManager()
+{
+    // defaults: full rate up close, then progressively slower
+    thresholds = { 3000.0f, 8000.0f, 20000.0f };
+    intervals = { 0.0f, 0.1f, 0.25f, 1.0f };
+}
+
+// the bookkeeping that AccumulatedDelta uses lives on the actor itself so that Tick doesn't need a map lookup
+static double* _LastTickTime(AActor* actor)
+{
+    if (AActor_CGLUE* a = Cast<AActor_CGLUE>(actor))
+        return &a->lodLastTickTime;
+    if (APawn_CGLUE* p = Cast<APawn_CGLUE>(actor))
+        return &p->lodLastTickTime;
+    if (ACharacter_CGLUE* c = Cast<ACharacter_CGLUE>(actor))
+        return &c->lodLastTickTime;
+    return nullptr;
+}
+
+void FTickLODManager::Register(AActor* actor)
+{
+    if (!IsValid(actor) || actorToEntry.Contains(actor))
+        return;
+    double* lastTickTime = _LastTickTime(actor);
+    if (!lastTickTime)
+    {
+        LWARN("%s is not a Python actor class, so it can't use tick LOD", *actor->GetName());
+        return;
+    }
+    UWorld* world = actor->GetWorld();
+    *lastTickTime = world ? world->GetTimeSeconds() : 0.0;
+
+    FEntry e;
+    e.actor = actor;
+    e.key = actor;
+    e.origInterval = actor->GetActorTickInterval();
+    actorToEntry.Add(actor, entries.Emplace(e));
+
+    if (!tickerHandle.IsValid())
+        SetUpdateInterval(updateInterval);
+}
+
+void FTickLODManager::Unregister(AActor* actor)
+{
+    int32* index = actorToEntry.Find(actor);
+    if (!index)
+        return;
+    if (IsValid(actor))
+    {
+        actor->SetActorTickInterval(entries[*index].origInterval);
+        double* lastTickTime = _LastTickTime(actor);
+        if (lastTickTime)
+            *lastTickTime = -1.0;
+    }
+    RemoveEntry(*index);
+}
+
+void FTickLODManager::RemoveEntry(int32 index)
+{
+    actorToEntry.Remove(entries[index].key);
+    entries.RemoveAtSwap(index);
+    if (index < entries.Num())
+        actorToEntry[entries[index].key] = index;
+}
+
+bool FTickLODManager::SetBuckets(const TArray<float>& newThresholds, const TArray<float>& newIntervals)
+{
+    if (newIntervals.Num() != newThresholds.Num() + 1)
+        return false;
+    thresholds = newThresholds;
+    intervals = newIntervals;
+    for (FEntry& e : entries)
+        e.bucket = -1; // so everybody gets their interval set again as they're re-evaluated
+    return true;
+}
+
+void FTickLODManager::SetScorer(py::object& newScorer)
+{
+    scorer = newScorer;
+}
+
+void FTickLODManager::SetUpdateInterval(float interval)
+{
+    updateInterval = interval;
+    if (tickerHandle.IsValid())
+        FTicker::GetCoreTicker().RemoveTicker(tickerHandle);
+    tickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float dt)
+    {
+        try {
+            Update();
+        } catchpy;
+        return true; // true = repeat
+    }), updateInterval);
+}
+
+void FTickLODManager::Update()
+{
+    // gather the next slice, along with each actor's distance to the nearest viewpoint in its world
+    TArray<AActor*> actors;
+    TArray<float> scores;
+    TMap<UWorld*, TArray<FVector>> viewpoints;
+    int32 count = FMath::Min(maxPerUpdate, entries.Num());
+    for (int32 n=0; n < count && entries.Num() > 0; n++)
+    {
+        if (cursor >= entries.Num())
+            cursor = 0;
+        AActor* actor = entries[cursor].actor.Get();
+        if (!IsValid(actor) || actor->IsPendingKillPending())
+        {
+            RemoveEntry(cursor); // and now some other entry is at cursor
+            continue;
+        }
+        cursor++;
+
+        UWorld* world = actor->GetWorld();
+        TArray<FVector>* views = viewpoints.Find(world);
+        if (!views)
+        {
+            views = &viewpoints.Add(world);
+            if (world)
+            {
+                for (FConstPlayerControllerIterator it = world->GetPlayerControllerIterator(); it; ++it)
+                {
+                    APlayerController* pc = it->Get();
+                    if (!IsValid(pc))
+                        continue;
+                    FVector loc;
+                    FRotator rot;
+                    pc->GetPlayerViewPoint(loc, rot);
+                    views->Emplace(loc);
+                }
+            }
+        }
+
+        float best = views->Num() ? FLT_MAX : 0.0f; // no viewpoints at all (e.g. no players yet) = full rate
+        FVector loc = actor->GetActorLocation();
+        for (const FVector& v : *views)
+            best = FMath::Min(best, FVector::Dist(loc, v));
+        actors.Emplace(actor);
+        scores.Emplace(best);
+    }
+    if (actors.Num() == 0)
+        return;
+
+    if (scorer && !scorer.is_none())
+    {   // let Python score the whole slice in one call
+        py::list pyActors;
+        for (AActor* a : actors)
+            pyActors.append(a);
+        py::object result = scorer(pyActors, MakePyBuffer(scores.GetData(), scores.Num()));
+        FPyBufferIn<float> pyScores(result, 1, "scores");
+        if (pyScores.count != actors.Num())
+            throw py::value_error("tick LOD scorer must return one score per actor");
+        FMemory::Memcpy(scores.GetData(), pyScores.data, scores.Num() * sizeof(float));
+    }
+
+    for (int32 i=0; i < actors.Num(); i++)
+    {
+        int32* index = actorToEntry.Find(actors[i]);
+        if (!index)
+            continue; // the scorer unregistered it
+        int32 bucket = 0;
+        while (bucket < thresholds.Num() && scores[i] >= thresholds[bucket])
+            bucket++;
+        FEntry& e = entries[*index];
+        if (bucket != e.bucket)
+        {
+            e.bucket = bucket;
+            actors[i]->SetActorTickInterval(intervals[bucket]);
+        }
+    }
+}
+
+int32 FTickLODManager::GetBucket(AActor* actor) const
+{
+    const int32* index = actorToEntry.Find(actor);
+    return index ? entries[*index].bucket : -1;
+}
+
+float FTickLODManager::AccumulatedDelta(AActor* actor, double& lastTickTime, float dt)
+{
+    if (lastTickTime < 0)
+        return dt;
+    UWorld* world = actor->GetWorld();
+    if (!world)
+        return dt;
+    double now = world->GetTimeSeconds();
+    float elapsed = (float)(now - lastTickTime);
+    lastTickTime = now;
+    return FMath::Max(elapsed, dt);
+}
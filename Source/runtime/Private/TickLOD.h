@@ -0,0 +1,51 @@
+// Tick rate LOD for Python actors: every registered actor (AActor_CGLUE, APawn_CGLUE, or ACharacter_CGLUE subclass) gets a
+// significance score - by default its distance to the nearest player viewpoint, or whatever a Python scoring function says -
+// and the score picks a bucket, and each bucket has a tick interval, so far away/unimportant actors make far fewer Tick calls
+// into Python. Scores are re-evaluated a slice at a time on a timer, and SetActorTickInterval is only called when an actor
+// actually changes buckets. When a throttled actor ticks, Python gets the full time since its last tick as its dt.
+
+#pragma once
+
+#include "uepy.h"
+
+class FTickLODManager
+{
+    struct FEntry
+    {
+        TWeakObjectPtr<AActor> actor;
+        AActor* key; // what's in actorToEntry; never deref'd
+        int32 bucket = -1;
+        float origInterval = 0.0f; // restored on unregister
+    };
+
+    TArray<FEntry> entries;
+    TMap<AActor*, int32> actorToEntry;
+    TArray<float> thresholds; // bucket i is for scores < thresholds[i]; the last bucket is for everything else
+    TArray<float> intervals; // one more than thresholds
+    py::object scorer;
+    int32 cursor = 0;
+    FDelegateHandle tickerHandle;
+
+    void RemoveEntry(int32 index);
+
+public:
+    int32 maxPerUpdate = 256; // how many actors get re-evaluated per update
+    float updateInterval = 0.2f; // seconds between updates - use SetUpdateInterval to change it
+
+    FTickLODManager();
+    static FTickLODManager& Get();
+
+    void Register(AActor* actor); // ignored if it's not one of the CGLUE actor classes
+    void Unregister(AActor* actor);
+    bool SetBuckets(const TArray<float>& thresholds, const TArray<float>& intervals); // false if the sizes don't line up
+    void SetScorer(py::object& scorer); // scorer(actors, distances) -> float32 buffer of scores, or None to just use distance
+    void Update(); // re-evaluates the next slice of actors
+    void SetUpdateInterval(float interval);
+    int32 GetBucket(AActor* actor) const; // -1 if not registered (or not evaluated yet)
+    int32 Num() const { return entries.Num(); }
+
+    // called from the CGLUE Tick implementations: returns the dt to pass to Python. lastTickTime is the actor's own
+    // bookkeeping, which is < 0 for actors that aren't managed (in which case dt is returned as-is).
+    static float AccumulatedDelta(AActor* actor, double& lastTickTime, float dt);
+};
+
@@ -8,6 +8,11 @@
 #include "CineCameraComponent.h"
 #include "Components/BoxComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "ActorPool.h"
+#include "ComponentIndex.h"
+#include "ObjectRegistry.h"
+#include "PyEvent.h"
+#include "PyForward.h"
 #include "Components/DecalComponent.h"
 #include "Components/PostProcessComponent.h"
 #include "Components/SceneCaptureComponent2D.h"
@@ -22,6 +27,7 @@
 #include "Components/WidgetInteractionComponent.h"
 #include "CubemapUnwrapUtils.h"
 #include "Curves/CurveFloat.h"
+#include "Curves/CurveLinearColor.h"
 #include "Curves/CurveVector.h"
 #include "Engine/CanvasRenderTarget2D.h"
 #include "Engine/Font.h"
@@ -35,6 +41,7 @@
 #include "Engine/TextureRenderTargetCube.h"
 #include "EngineUtils.h"
 #include "ExternalAssets.h"
+#include "mod_uepy_batch.h"
 #include "FileMediaSource.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/PawnMovementComponent.h"
@@ -219,15 +226,46 @@ struct FHackyAttenuationSettings
 };
 
 static std::map<FString, py::object> pyClassMap; // class name --> python class
+
+// Per-UClass info for the classes made by RegisterPythonSubclass, so that the class constructor can get everything it needs
+// with one lookup by class pointer (UClass* keys are never deref'd; a re-registered class keeps its UClass and just has its
+// entry updated).
+struct FPyClassInfo
+{
+    py::object pyClass;
+    UClass* parentClass = nullptr; // the engine class it was registered on top of
+    int32 numConstructed = 0;
+    uint64 constructCycles = 0; // total time spent in the Python side of construction
+};
+static TMap<const UClass*, FPyClassInfo> pyClassInfo;
+static py::object internalSpawnArgs; // null when there aren't any
+
+// finds the info for klass or, e.g. for Blueprint subclasses of Python classes, its nearest ancestor that has some
+static FPyClassInfo* _FindPyClassInfo(const UClass* klass)
+{
+    for (; klass; klass = klass->GetSuperClass())
+    {
+        FPyClassInfo* info = pyClassInfo.Find(klass);
+        if (info)
+            return info;
+    }
+    return nullptr;
+}
+
+static bool _IsPythonSubclass(const UClass* klass)
+{
+    return pyClassInfo.Contains(klass);
+}
+
 void SetInternalSpawnArgs(py::dict& kwargs)
 {
     if (py::len(kwargs) > 0) // only set them if they have a value; sometimes we have cases where an outer object sets them, e.g. CreateWidget -> NewObject
-        py::module::import("_uepy").attr("spawnArgs") = kwargs;
+        internalSpawnArgs = kwargs;
 }
 
 void ClearInternalSpawnArgs()
-{
-    py::module::import("_uepy").attr("spawnArgs").attr("clear")();
+{   // just drop our reference; emptying the dict would also empty it for a caller that reuses it (e.g. ActorPool.Prewarm)
+    internalSpawnArgs = py::object();
 }
 
 py::object GetPyClassFromName(FString& name)
@@ -240,14 +278,163 @@ py::object GetPyClassFromName(FString& name)
 
 using namespace pybind11::literals;
 
+// spawns an actor, passing kwargs either to its Python __init__ (for Python subclasses) or setting them as properties
+static AActor* _SpawnActor(UWorld* world, UClass* actorClass, const FTransform& transform, py::dict& kwargs)
+{
+    if (py::len(kwargs) == 0)
+    {   // one-shot spawn because no extra params were passed
+        FActorSpawnParameters info;
+        info.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        return world->SpawnActor(actorClass, &transform, info);
+    }
+
+    // caller also wants to pass in some params so we need to do a multi-step spawn. If the class is actually a Python subclass of an engine class,
+    // we pass the kwargs directly to the constructor via a bit of hackery. This is both more efficient but, more importantly, it allows us to do
+    // some earlier initialization that is pretty much impossible any other way (assuming you want replication to work right).
+    bool directInit = false;
+    if (_IsPythonSubclass(actorClass))
+    {
+        directInit = true;
+        SetInternalSpawnArgs(kwargs);
+    }
+
+    AActor *actor = world->SpawnActorDeferred<AActor>(actorClass, transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (!actor)
+    {
+        LERROR("Failed to spawn actor");
+        ClearInternalSpawnArgs();
+        return nullptr;
+    }
+
+    if (!directInit)
+    {   // fall back to the engine way of two-step init
+        for (auto item : kwargs)
+        {
+            std::string k = item.first.cast<std::string>();
+            py::object v = py::cast<py::object>(item.second);
+            SetObjectProperty(actor, k, v);
+        }
+    }
+
+    UGameplayStatics::FinishSpawningActor(actor, transform);
+    return actor;
+}
+
+// A batch of actors being spawned by SpawnActors. transforms are copied out of the caller's buffer up front so that a
+// budgeted batch can be spread over several frames.
+struct FSpawnBatch
+{
+    TWeakObjectPtr<UWorld> world;
+    TWeakObjectPtr<UClass> klass;
+    bool directInit = false; // true if klass is a Python subclass, in which case kwargs go to its __init__
+    TArray<FTransform> transforms;
+    py::dict sharedKwargs;
+    py::object perInstanceKwargs; // None or a sequence of dicts, one per actor
+    TArray<TPair<FProperty*, py::object>> sharedProps; // sharedKwargs, already resolved to properties (!directInit only)
+    TMap<FString, FProperty*> propCache; // property lookups for perInstanceKwargs
+    TArray<int64> handles; // see UObjectToHandle, 0 for failed spawns
+    int32 next = 0;
+
+    FProperty* FindProp(UClass* k, const FString& name)
+    {
+        FProperty** cached = propCache.Find(name);
+        if (cached)
+            return *cached;
+        FProperty* prop = k->FindPropertyByName(FName(*name));
+        if (!prop)
+            LERROR("Failed to find property %s on class %s", *name, *k->GetName());
+        return propCache.Add(name, prop);
+    }
+
+    // spawns the i'th actor, returning it or null on failure; may throw (e.g. from a bad kwarg)
+    AActor* SpawnOne(UWorld* w, UClass* k, int32 i)
+    {
+        FTransform& transform = transforms[i];
+        py::dict instKwargs;
+        if (!perInstanceKwargs.is_none())
+        {
+            py::object o = perInstanceKwargs[py::int_(i)];
+            if (!o.is_none())
+                instKwargs = o.cast<py::dict>();
+        }
+        if (directInit)
+        {
+            // a real copy (py::dict's copy ctor just shares the dict), so the per-instance ones don't leak into the next actor
+            py::dict kwargs = sharedKwargs.attr("copy")();
+            kwargs.attr("update")(instKwargs);
+            SetInternalSpawnArgs(kwargs);
+        }
+
+        AActor* actor = w->SpawnActorDeferred<AActor>(k, transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+        if (!actor)
+        {
+            LERROR("Failed to spawn actor %d of %s", i, *k->GetName());
+            ClearInternalSpawnArgs();
+            return nullptr;
+        }
+
+        try {
+            if (!directInit)
+            {
+                for (TPair<FProperty*, py::object>& entry : sharedProps)
+                    if (!_setuprop(entry.Key, (uint8*)actor, entry.Value, 0))
+                        LERROR("Failed to set property %s on %s", *entry.Key->GetName(), *actor->GetName());
+                for (auto item : instKwargs)
+                {
+                    std::string _name = item.first.cast<std::string>();
+                    FProperty* prop = FindProp(k, FSTR(_name));
+                    py::object v = py::reinterpret_borrow<py::object>(item.second);
+                    if (prop && !_setuprop(prop, (uint8*)actor, v, 0))
+                        LERROR("Failed to set property %s on %s", *prop->GetName(), *actor->GetName());
+                }
+            }
+            UGameplayStatics::FinishSpawningActor(actor, transform);
+        } catch (...)
+        {   // don't leave a half-set-up actor lying around
+            if (!actor->IsActorInitialized())
+                actor->Destroy();
+            throw;
+        }
+        return actor;
+    }
+
+    // spawns actors until all have been spawned (returns true) or until deadline (in FPlatformTime::Seconds) is reached
+    bool Step(double deadline)
+    {
+        UWorld* w = world.Get();
+        UClass* k = klass.Get();
+        if (!w || !k)
+        {   // the world or class went away; whatever's left just fails
+            handles.SetNumZeroed(transforms.Num());
+            next = transforms.Num();
+            return true;
+        }
+
+        while (next < transforms.Num())
+        {
+            int32 i = next++;
+            try {
+                handles.Emplace(UObjectToHandle(SpawnOne(w, k, i)));
+            } catch (std::exception& e)
+            {   // a bad kwarg or the like only fails this actor, so the caller still gets all the others
+                LERROR("Failed to spawn actor %d of %s: %s", i, *k->GetName(), UTF8_TO_TCHAR(e.what()));
+                ClearInternalSpawnArgs();
+                handles.Emplace(0);
+            }
+
+            if (deadline > 0 && FPlatformTime::Seconds() >= deadline)
+                break;
+        }
+        return next >= transforms.Num();
+    }
+};
+
 // this module is automagically loaded by virtual of the global declaration and the use of the embedded module macro
 // other builtin modules get added via FUEPythonDelegates::LaunchInit
 PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module uses _<name> and then we provide a <name> .py wrapper for additional stuffs
     // ALL Python-subclassable classes should live here (i.e. all C++ _CGLUE classes should be exposed via this submodule)
     py::module glueclasses = m.def_submodule("glueclasses");
 
-    m.attr("spawnArgs") = py::dict();
-
     // note that WITH_EDITOR does not necessarily mean that the uepyEditor module will be loaded
 #if WITH_EDITOR
     m.attr("WITH_EDITOR") = true;
@@ -287,18 +474,123 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         return ret;
     });
 
-    m.def("GetUObjectsOfClass", [](py::object& _klass)
+    // object population snapshots, for finding leaks - see FObjectSnapshot
+    py::class_<FObjectSnapshot>(m, "ObjectSnapshot")
+        .def_readonly("time", &FObjectSnapshot::time)
+        .def_readonly("totalObjects", &FObjectSnapshot::totalObjects)
+        .def_readonly("hasResourceSizes", &FObjectSnapshot::hasResourceSizes)
+        .def("__len__", [](FObjectSnapshot& self) { return self.classes.Num(); })
+        .def_property_readonly("classes", [](FObjectSnapshot& self)
+        {   // class name --> (count, resourceBytes)
+            py::dict ret;
+            for (auto& entry : self.classes)
+                ret[PYSTR(entry.Key)] = py::make_tuple(entry.Value.count, entry.Value.resourceBytes);
+            return ret;
+        })
+        .def("GetCount", [](FObjectSnapshot& self, std::string& className)
+        {
+            FObjectSnapshot::FClassStats* stats = self.classes.Find(FSTR(className));
+            return stats ? stats->count : 0;
+        })
+        .def("WriteCSV", [](FObjectSnapshot& self, std::string& filename) { self.WriteCSVAsync(FSTR(filename)); })
+        ;
+
+    // captures the current object population and calls callback(ObjectSnapshot) once it has been processed (on a later frame)
+    m.def("TakeObjectSnapshot", [](py::object& callback, bool includeResourceSize)
     {
-        UClass *klass = PyObjectToUClass(_klass);
-        py::list objs;
-        for (TObjectIterator<UObject> iter; iter; ++iter)
+        py::object* cb = new py::object(callback); // only ever touched on the game thread
+        FObjectSnapshot::TakeAsync(includeResourceSize, [cb](FObjectSnapshot* snapshot)
         {
-            UObject* obj = *iter;
-            if (obj && IsValid(obj) && obj->IsA(klass))
-                objs.append(obj);
+            try {
+                (*cb)(py::cast(snapshot, py::return_value_policy::take_ownership));
+            } catchpy;
+            delete cb;
+        });
+    }, "callback"_a, "includeResourceSize"_a=false);
+
+    // returns a list of (className, countA, countB, countDelta, bytesDelta) for every class whose count or size changed from
+    // a to b, biggest growth first
+    m.def("DiffObjectSnapshots", [](FObjectSnapshot& a, FObjectSnapshot& b)
+    {
+        struct FDiff
+        {
+            FString name;
+            int32 countA, countB;
+            int64 bytesDelta;
+        };
+        TArray<FDiff> diffs;
+        FObjectSnapshot::FClassStats none;
+        for (auto& entry : b.classes)
+        {
+            FObjectSnapshot::FClassStats* old = a.classes.Find(entry.Key);
+            if (!old)
+                old = &none;
+            if (old->count != entry.Value.count || old->resourceBytes != entry.Value.resourceBytes)
+                diffs.Add({entry.Key, old->count, entry.Value.count, entry.Value.resourceBytes - old->resourceBytes});
         }
+        for (auto& entry : a.classes)
+            if (!b.classes.Contains(entry.Key))
+                diffs.Add({entry.Key, entry.Value.count, 0, -entry.Value.resourceBytes});
+        diffs.Sort([](const FDiff& x, const FDiff& y) { return (x.countB - x.countA) > (y.countB - y.countA); });
+
+        py::list ret;
+        for (FDiff& d : diffs)
+            ret.append(py::make_tuple(PYSTR(d.name), d.countA, d.countB, d.countB - d.countA, d.bytesDelta));
+        return ret;
+    });
+
+    py::class_<FPyObjectIterator>(m, "ObjectIterator")
+        .def("__iter__", [](py::object& self) { return self; })
+        .def("__next__", [](FPyObjectIterator& self) -> UObject*
+        {
+            UObject* obj = self.next();
+            if (!obj)
+                throw py::stop_iteration();
+            return obj;
+        }, py::return_value_policy::reference)
+        ;
+
+    // the *OfClass functions use the object registry (see ObjectRegistry.h), so only the first call for a given class
+    // has to scan; after that they cost about the same as the number of objects returned.
+    m.def("GetUObjectsOfClass", [](py::object& _klass, UWorld* world)
+    {
+        TArray<FWeakObjectPtr> found;
+        FObjectRegistry::Get().GetObjects(PyObjectToUClass(_klass), world, found);
+        py::list objs;
+        for (FWeakObjectPtr& obj : found)
+            objs.append(obj.Get());
         return objs;
-    }, py::return_value_policy::reference);
+    }, py::return_value_policy::reference, "klass"_a, "world"_a=nullptr);
+    m.def("IterUObjectsOfClass", [](py::object& _klass, UWorld* world, py::object& tag, py::object& name)
+    {
+        py::object noKlass = py::none(); // klass is already handled by the registry
+        FObjectFilter filter = FObjectFilter::FromPy(noKlass, tag, name);
+        TArray<FWeakObjectPtr> found;
+        FObjectRegistry::Get().GetObjects(PyObjectToUClass(_klass), world, found);
+        return new FPyObjectIterator([found=MoveTemp(found), filter, pos=0]() mutable -> UObject*
+        {
+            while (pos < found.Num())
+            {
+                UObject* obj = found[pos++].Get();
+                if (obj && filter.Matches(obj))
+                    return obj;
+            }
+            return nullptr;
+        });
+    }, py::return_value_policy::take_ownership, "klass"_a, "world"_a=nullptr, "tag"_a=py::none(), "name"_a=py::none());
+    m.def("GetUObjectHandlesOfClass", [](py::object& _klass, UWorld* world)
+    {   // returns an int64 buffer of object handles (see UObjectFromHandle)
+        TArray<FWeakObjectPtr> found;
+        FObjectRegistry::Get().GetObjects(PyObjectToUClass(_klass), world, found);
+        TArray<int64> handles;
+        handles.Reserve(found.Num());
+        for (FWeakObjectPtr& obj : found)
+            handles.Emplace(UObjectToHandle(obj.Get()));
+        return MakePyBuffer(handles.GetData(), handles.Num());
+    }, "klass"_a, "world"_a=nullptr);
+    m.def("UObjectToHandle", [](UObject* obj) { return UObjectToHandle(obj); });
+    m.def("UObjectFromHandle", [](int64 handle) { return UObjectFromHandle(handle); }, py::return_value_policy::reference); // None if the object is gone
+    m.def("GetNumTrackedClasses", []() { return FObjectRegistry::Get().NumTrackedClasses(); });
 
     m.def("DumpUObjectList", [](std::string& filename, bool full)
     {
@@ -334,9 +626,76 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         return ret;
     }, py::return_value_policy::reference);
 
+    // Name lookups via the object name index (see ObjectRegistry.h) - unlike FindMatchingUObjects, these don't look at every
+    // object in the process. All are case-insensitive. within (e.g. a package or world) and klass optionally narrow the results.
+    auto findByName = [](void (FObjectNameIndex::*find)(const FString&, UObject*, UClass*, TArray<UObject*>&), std::string& name, UObject* within, py::object& _klass)
+    {
+        UClass* klass = _klass.is_none() ? nullptr : PyObjectToUClass(_klass);
+        TArray<UObject*> found;
+        (FObjectNameIndex::Get().*find)(FSTR(name), within, klass, found);
+        py::list ret;
+        for (UObject* obj : found)
+            ret.append(obj);
+        return ret;
+    };
+    m.def("FindUObjectsByName", [findByName](std::string& name, UObject* within, py::object& klass) { return findByName(&FObjectNameIndex::FindExact, name, within, klass); },
+        py::return_value_policy::reference, "name"_a, "within"_a=nullptr, "klass"_a=py::none());
+    m.def("FindUObjectsByPrefix", [findByName](std::string& prefix, UObject* within, py::object& klass) { return findByName(&FObjectNameIndex::FindPrefix, prefix, within, klass); },
+        py::return_value_policy::reference, "prefix"_a, "within"_a=nullptr, "klass"_a=py::none());
+    m.def("FindUObjectsByWildcard", [findByName](std::string& pattern, UObject* within, py::object& klass) { return findByName(&FObjectNameIndex::FindWildcard, pattern, within, klass); },
+        py::return_value_policy::reference, "pattern"_a, "within"_a=nullptr, "klass"_a=py::none());
+    m.def("GetUObjectsWithOuter", [](UObject* outer, bool includeNested)
+    {
+        TArray<UObject*> objs;
+        GetObjectsWithOuter(outer, objs, includeNested);
+        py::list ret;
+        for (UObject* obj : objs)
+            if (IsValid(obj))
+                ret.append(obj);
+        return ret;
+    }, py::return_value_policy::reference, "outer"_a, "includeNested"_a=true);
+
+    // lazy version of FindMatchingUObjects. It walks the global object array one step at a time (by index, so it's fine to
+    // hold on to the iterator across frames/GCs), so e.g. stopping at the first match doesn't cost a full scan.
+    m.def("IterMatchingUObjects", [](py::object& search, py::object& klass, py::object& tag)
+    {
+        FObjectFilter filter = FObjectFilter::FromPy(klass, tag, search);
+        return new FPyObjectIterator([filter, index=0]() mutable -> UObject*
+        {
+            while (index < GUObjectArray.GetObjectArrayNum())
+            {
+                FUObjectItem* item = GUObjectArray.IndexToObject(index++);
+                UObject* obj = item ? (UObject*)item->Object : nullptr;
+                if (!obj || item->IsPendingKill() || item->IsUnreachable() || obj->HasAnyFlags(RF_ClassDefaultObject))
+                    continue;
+                if (filter.Matches(obj))
+                    return obj;
+            }
+            return nullptr;
+        });
+    }, py::return_value_policy::take_ownership, "search"_a=py::none(), "klass"_a=py::none(), "tag"_a=py::none());
+
     m.def("IsInGameThread", []() { return IsInGameThread(); });
     m.def("IsInSlateThread", []() { return IsInSlateThread(); });
 
+    // native base class of uepy.Event - see PyEvent.h
+    py::class_<FPyEvent>(m, "EventBase", py::dynamic_attr())
+        .def(py::init<>())
+        .def("_Add", [](FPyEvent& self, py::object& method) { self.Add(method); })
+        .def("_Remove", [](FPyEvent& self, py::object& method) { return self.Remove(method); })
+        .def("RemoveOn", [](FPyEvent& self, py::object& owner) { self.RemoveOn(owner); })
+        .def("RemoveAll", [](FPyEvent& self) { self.RemoveAll(); })
+        .def("Fire", [](FPyEvent& self, py::args args, py::kwargs kwargs) { self.Fire(args, kwargs); })
+        .def_property_readonly("numCallbacks", [](FPyEvent& self) { return self.Num(); }) // not __len__, so empty events are still truthy
+        .def_property_readonly("callbacks", [](FPyEvent& self) { return self.GetCallbacks(); })
+        .def_readonly("fireCount", &FPyEvent::fireCount)
+        .def_readonly("fireSeconds", &FPyEvent::fireSeconds)
+        .def("ResetStats", [](FPyEvent& self) { self.fireCount = 0; self.fireSeconds = 0; })
+        ;
+
+    // used by uepy.FORWARDS - see PyForward.h
+    m.def("_MakeForward", [](std::string& name, bool returns) { return MakePyForward(name, returns); }, "name"_a, "returns"_a=true);
+
     // Returns true if VR is enabled for reals: there's an HMD, it's connected, *and* stereo rendering is enabled. This
     // function is able to detect PIE VR Preview mode.
     m.def("IsVREnabled", []()
@@ -440,6 +799,21 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         return bSaved;
     });
 
+    // pooled allocation for the small value types (see uepy_valuetypes.h)
+    m.def("SetValuePoolEnabled", [](bool enabled) { SetPyValuePoolEnabled(enabled); });
+    m.def("GetValuePoolStats", []()
+    {
+        FPyValuePoolStats stats = GetPyValuePoolStats();
+        py::dict ret;
+        ret["enabled"] = PyValuePoolEnabled();
+        ret["slabs"] = stats.numSlabs;
+        ret["inUse"] = stats.numInUse;
+        ret["allocs"] = stats.numAllocs;
+        ret["fallbacks"] = stats.numFallbacks;
+        return ret;
+    });
+    m.def("ResetValuePoolStats", []() { ResetPyValuePoolStats(); });
+
     py::class_<FVector4>(m, "FVector4")
         .def(py::init<FVector4>())
         .def(py::init<float,float,float,float>())
@@ -453,7 +827,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def_readwrite("W", &FVector4::W)
         ;
 
-    py::class_<FVector2D>(m, "FVector2D")
+    py::class_<FVector2D, TPyValueHolder<FVector2D>>(m, "FVector2D")
         .def(py::init<FVector2D>())
         .def(py::init([](float n) { return FVector2D(n,n); })) // note this special case of FVector(a) === FVector(a,a,a)
         .def(py::init<float,float>(), "x"_a=0.0f, "y"_a=0.0f)
@@ -480,7 +854,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("Equals", [](FVector2D& self, FVector2D &other, float tolerance) { return self.Equals(other, tolerance); }, py::arg("other"), py::arg("tolerance")=KINDA_SMALL_NUMBER)
         ;
 
-    py::class_<FVector>(m, "FVector")
+    py::class_<FVector, TPyValueHolder<FVector>>(m, "FVector")
         .def(py::init<FVector>())
         .def(py::init([]() { return FVector(0,0,0); }))
         .def(py::init([](float n) { return FVector(n,n,n); })) // note this special case of FVector(a) === FVector(a,a,a)
@@ -541,7 +915,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("GetClampedToMaxSize", [](FVector& self, float maxSize) { return self.GetClampedToMaxSize(maxSize); })
         ;
 
-    py::class_<FRotator>(m, "FRotator")
+    py::class_<FRotator, TPyValueHolder<FRotator>>(m, "FRotator")
         .def(py::init<FRotator>())
         .def(py::init([]() { return FRotator(0,0,0); }))
         .def(py::init([](float n) { return FRotator(n,n,n); })) // note this special case of FRotator(a) === FRotator(a,a,a)
@@ -566,7 +940,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("Vector", [](FRotator& self) { return self.Vector(); })
         ;
 
-    py::class_<FQuat>(m, "FQuat")
+    py::class_<FQuat, TPyValueHolder<FQuat>>(m, "FQuat")
         .def(py::init([](bool init) { if (init) return FQuat(EForceInit::ForceInit); else return FQuat(); }))
         .def(py::init<FQuat>())
         .def(py::init<FRotator>())
@@ -721,7 +1095,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def(py::init<FRotator>())	
         ;
 
-    py::class_<FColor>(m, "FColor")
+    py::class_<FColor, TPyValueHolder<FColor>>(m, "FColor")
         .def(py::init<FColor>())
         .def(py::init<int, int, int, int>(), "r"_a=0, "g"_a=0, "b"_a=0, "a"_a=0)
         .def_readwrite("R", &FColor::R)
@@ -735,7 +1109,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("__iter__", [](FColor& self) { return py::make_tuple(self.R, self.G, self.B, self.A).attr("__iter__")(); })
         ;
 
-    py::class_<FLinearColor>(m, "FLinearColor")
+    py::class_<FLinearColor, TPyValueHolder<FLinearColor>>(m, "FLinearColor")
         .def(py::init<FLinearColor>())
         .def(py::init<float, float, float, float>(), "r"_a=0.0f, "g"_a=0.0f, "b"_a=0.0f, "a"_a=1.0f)
         .def(py::init<FVector>())
@@ -912,10 +1286,17 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
 
     UEPY_EXPOSE_CLASS(UCurveFloat, UCurveBase, m)
         .def("GetFloatValue", [](UCurveFloat& self, float f) { return self.GetFloatValue(f); })
+        .def("EvaluateBatch", [](UCurveFloat& self, py::object& times) { return EvaluateCurveBatch(&self, times); })
         ;
 
     UEPY_EXPOSE_CLASS(UCurveVector, UCurveBase, m)
         .def("GetVectorValue", [](UCurveVector& self, float f) { return self.GetVectorValue(f); })
+        .def("EvaluateBatch", [](UCurveVector& self, py::object& times) { return EvaluateCurveBatch(&self, times); })
+        ;
+
+    UEPY_EXPOSE_CLASS(UCurveLinearColor, UCurveBase, m)
+        .def("GetLinearColorValue", [](UCurveLinearColor& self, float f) { return self.GetLinearColorValue(f); })
+        .def("EvaluateBatch", [](UCurveLinearColor& self, py::object& times) { return EvaluateCurveBatch(&self, times); })
         ;
 
     UEPY_EXPOSE_CLASS(UFont, UObject, m)
@@ -943,38 +1324,39 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("SetIsReplicated", [](UActorComponent& self, bool b) { self.SetIsReplicated(b); })
         .def("IsRegistered", [](UActorComponent& self) { return self.IsRegistered(); })
         .def("SetComponentTickEnabled", [](UActorComponent& self, bool enabled) { self.SetComponentTickEnabled(enabled); })
-        .def("RegisterComponent", [](UActorComponent& self) { self.RegisterComponent(); })
-        .def("UnregisterComponent", [](UActorComponent& self) { self.UnregisterComponent(); })
-        .def("DestroyComponent", [](UActorComponent& self) { self.DestroyComponent(); })
+        .def("RegisterComponent", [](UActorComponent& self) { self.RegisterComponent(); FComponentIndex::Invalidate(&self); })
+        .def("UnregisterComponent", [](UActorComponent& self) { self.UnregisterComponent(); FComponentIndex::Invalidate(&self); })
+        .def("DestroyComponent", [](UActorComponent& self) { FComponentIndex::Invalidate(&self); self.DestroyComponent(); })
         BIT_PROP(bAutoActivate, UActorComponent)
         .def("IsActive", [](UActorComponent& self) { return self.IsActive(); })
         .def("Activate", [](UActorComponent& self, bool reset) { self.Activate(reset); }, "reset"_a=false)
         .def("Deactivate", [](UActorComponent& self) { self.Deactivate(); })
         .def("SetActivated", [](UActorComponent& self, bool a) { if (a) self.Activate(); else self.Deactivate(); })
-        .def("ComponentHasTag", [](UActorComponent& self, std::string& tag) { return self.ComponentHasTag(FSTR(tag)); })
+        .def("ComponentHasTag", [](UActorComponent& self, FName& tag) { return self.ComponentHasTag(tag); })
         .def("HasAnyTags", [](UActorComponent& self, py::list& pytags) // returns true if any of the given tags are present
         {
             for (const py::handle pytag : pytags)
             {
-                if (self.ComponentHasTag(FSTR(pytag.cast<std::string>())))
+                if (self.ComponentHasTag(pytag.cast<FName>()))
                     return true;
             }
             return false;
         })
-        .def("AddTag", [](UActorComponent& self, std::string& tag) { self.ComponentTags.AddUnique(FName(FSTR(tag))); })
-        .def("RemoveTag", [](UActorComponent& self, std::string& tag) { self.ComponentTags.Remove(FName(FSTR(tag))); })
+        .def("AddTag", [](UActorComponent& self, FName& tag) { self.ComponentTags.AddUnique(tag); FComponentIndex::Invalidate(&self); })
+        .def("RemoveTag", [](UActorComponent& self, FName& tag) { self.ComponentTags.Remove(tag); FComponentIndex::Invalidate(&self); })
         .def_property("ComponentTags", [](UActorComponent& self)
             {
                 py::list ret;
                 for (FName& tag : self.ComponentTags)
-                    ret.append(PYSTR(tag.ToString()));
+                    ret.append(tag);
                 return ret;
             },
             [](UActorComponent& self, py::list pytags)
             {
                 self.ComponentTags.Empty();
                 for (const py::handle pytag : pytags)
-                    self.ComponentTags.Emplace(FSTR(pytag.cast<std::string>()));
+                    self.ComponentTags.Emplace(pytag.cast<FName>());
+                FComponentIndex::Invalidate(&self);
             })
         ;
 
@@ -1040,7 +1422,10 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
                 socketName = FSTR(socket);
                 rules = FAttachmentTransformRules::SnapToTargetNotIncludingScale;
             }
-            return self.AttachToComponent(parent, rules, socketName);
+            FComponentIndex::InvalidateAttachChain(&self);
+            bool ret = self.AttachToComponent(parent, rules, socketName);
+            FComponentIndex::InvalidateAttachChain(parent);
+            return ret;
         }, py::arg("parent"), py::arg("socket")="", py::arg("attachmentRule")=0)
 
         .def("SetupAttachment", [](USceneComponent& self, USceneComponent *parent, std::string socketName)
@@ -1049,9 +1434,10 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
                 self.SetupAttachment(parent, FSTR(socketName));
             else
                 self.SetupAttachment(parent);
+            FComponentIndex::InvalidateAttachChain(parent);
         }, py::arg("parent"), py::arg("socketName")="")
 
-        .def("DetachFromComponent", [](USceneComponent& self) { self.DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform); })
+        .def("DetachFromComponent", [](USceneComponent& self) { FComponentIndex::InvalidateAttachChain(&self); self.DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform); })
         .def("SetRelativeLocationAndRotation", [](USceneComponent& self, FVector& loc, FRotator& rot) { self.SetRelativeLocationAndRotation(loc, rot); })
         .def("SetWorldLocationAndRotation", [](USceneComponent& self, FVector& loc, FRotator& rot) { self.SetWorldLocationAndRotation(loc, rot); })
         .def("SetWorldLocationAndRotation", [](USceneComponent& self, FVector& loc, FQuat& rot) { self.SetWorldLocationAndRotation(loc, rot); })
@@ -1211,6 +1597,10 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("ResetSystem", [](UNiagaraComponent& self) { self.ResetSystem(); })
         .def("ReinitializeSystem", [](UNiagaraComponent& self) { self.ReinitializeSystem(); })
         .def("SetTickBehavior", [](UNiagaraComponent& self, int t) { self.SetTickBehavior((ENiagaraTickBehavior)t); })
+        .def("SetNiagaraArrayFloat", &SetNiagaraArrayFloat) // name can be a str or NiagaraParamHandle, values a float32 buffer
+        .def("SetNiagaraArrayVector", &SetNiagaraArrayVector) // values is float32, 3 per vector
+        .def("SetNiagaraArrayColor", &SetNiagaraArrayColor) // values is float32, 4 per color
+        .def("SetNiagaraArrayInt32", &SetNiagaraArrayInt32)
         .def("SetVariables", [](UNiagaraComponent& self, py::kwargs& kwargs)
         {   // helper because it's tedious to have to inspect types and call the respective API directly - but be aware that we don't coerce ints to floats!
             for (auto item : kwargs)
@@ -1311,32 +1701,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
                 return origMats->GetData()[index]; // we are in override mode, so return the original
             return self->GetMaterial(index);
         }, py::return_value_policy::reference)
-        .def("SetOverrideMaterial", [](UMeshComponent* self, UMaterialInterface* newMat) // TODO: I think override mode is broken for SMC when we dynamically switch meshes
-        {   // this enters/exits material override mode - mat=None to exit
-            int matCount = self->GetNumMaterials();
-            FPyObjectTracker* tracker = FPyObjectTracker::Get();
-            MaterialArray* origMats = tracker->matOverrideMeshComps.Find(self);
-            if (newMat)
-            {   // caller passed a material, so they want to begin overriding
-                if (!origMats) // if we're already overriding, we've already saved the original materials, so we don't want to stomp them
-                {
-                    MaterialArray mats;
-                    mats.SetNumZeroed(matCount);
-                    for (int i=0; i < matCount; i++)
-                    {
-                        mats[i] = self->GetMaterial(i); // remember the old
-                        self->SetMaterial(i, newMat); // use the override
-                    }
-                    tracker->matOverrideMeshComps.Emplace(self, mats);
-                }
-            }
-            else if (origMats)
-            {   // leaving override mode, so restore the original mats
-                for (int i=0; i < matCount; i++)
-                    self->SetMaterial(i, origMats->GetData()[i]);
-                tracker->matOverrideMeshComps.Remove(self);
-            }
-        })
+        .def("SetOverrideMaterial", &SetOverrideMaterial) // enters/exits material override mode - mat=None to exit. See also SetOverrideMaterials.
         ;
 
     UEPY_EXPOSE_CLASS(UStaticMeshComponent, UMeshComponent, m)
@@ -1447,6 +1812,48 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
             }
             return ret;
         }, py::return_value_policy::reference)
+        .def("IterAllActors", [](UWorld* self, py::object& klass, py::object& tag, py::object& name)
+        {   // lazy version of GetAllActors. Walks the world's levels one actor at a time; doesn't hold any raw pointers
+            // between steps, so actors spawned or destroyed mid-iteration are fine.
+            FObjectFilter filter = FObjectFilter::FromPy(klass, tag, name);
+            TWeakObjectPtr<UWorld> world = self;
+            return new FPyObjectIterator([world, filter, levelIndex=0, actorIndex=0]() mutable -> UObject*
+            {
+                UWorld* w = world.Get();
+                if (!w)
+                    return nullptr;
+                const TArray<ULevel*>& levels = w->GetLevels();
+                while (levelIndex < levels.Num())
+                {
+                    ULevel* level = levels[levelIndex];
+                    if (!level || actorIndex >= level->Actors.Num())
+                    {
+                        levelIndex++;
+                        actorIndex = 0;
+                        continue;
+                    }
+                    AActor* actor = level->Actors[actorIndex++];
+                    if (IsValid(actor) && !actor->IsPendingKillOrUnreachable() && filter.Matches(actor))
+                        return actor;
+                }
+                return nullptr;
+            });
+        }, py::return_value_policy::take_ownership, "klass"_a=py::none(), "tag"_a=py::none(), "name"_a=py::none())
+        .def("IterAllPlayerControllers", [](UWorld* self)
+        {
+            TArray<FWeakObjectPtr> pcs;
+            for (FConstPlayerControllerIterator it = self->GetPlayerControllerIterator(); it; ++it)
+            {
+                APlayerController* pc = Cast<APlayerController>(*it);
+                if (IsValid(pc) && !pc->IsPendingKillOrUnreachable())
+                    pcs.Emplace(pc);
+            }
+            return FPyObjectIterator::FromWeakList(MoveTemp(pcs));
+        }, py::return_value_policy::take_ownership)
+        // batched queries that return QueryBatchResults - see mod_uepy_batch.h
+        .def("OverlapSphereBatch", &OverlapSphereBatch, py::arg("centers"), py::arg("radii"), py::arg("channel"), py::arg("params")=py::none())
+        .def("OverlapBoxBatch", &OverlapBoxBatch, py::arg("centers"), py::arg("extents"), py::arg("rotations")=py::none(), py::arg("channel")=(int)ECC_WorldDynamic, py::arg("params")=py::none())
+        .def("SweepBatch", &SweepBatch, py::arg("starts"), py::arg("ends"), py::arg("radii"), py::arg("channel"), py::arg("params")=py::none())
         ;
 
     // for use with engine-replicated actors only
@@ -1465,6 +1872,13 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
             ret.append(*iter);
         return ret;
     }, py::return_value_policy::reference);
+    m.def("IterAllWorlds", []()
+    {
+        TArray<FWeakObjectPtr> worlds;
+        for (TObjectIterator<UWorld> iter; iter; ++iter)
+            worlds.Emplace(*iter);
+        return FPyObjectIterator::FromWeakList(MoveTemp(worlds));
+    }, py::return_value_policy::take_ownership);
 
     py::class_<UGameplayStatics, UObject, UnrealTracker<UGameplayStatics>>(m, "UGameplayStatics") // not sure that it makes sense to really expose this fully
         .def_static("GetGameInstance", [](UWorld *world) { return UGameplayStatics::GetGameInstance(world); }, py::return_value_policy::reference)
@@ -1613,19 +2027,25 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
             bool hit = UKismetSystemLibrary::SphereTraceSingle(worldCtx, start, end, radius, (ETraceTypeQuery)channel, isComplex, ignore, (EDrawDebugTrace::Type)debugType, hitResult, ignoreSelf, traceColor, hitColor, drawTime);
             return py::make_tuple(hitResult, hit);
         }, py::return_value_policy::reference, py::arg("worldCtx"), py::arg("start"), py::arg("end"), py::arg("radius"), py::arg("channel"), py::arg("isComplex"), py::arg("_ignore"), py::arg("type")=(int)EDrawDebugTrace::None, py::arg("ignoreSelf")=true, py::arg("traceColor")=FLinearColor::Red, py::arg("hitColor")=FLinearColor::Green, py::arg("drawTime")=5.0f)
-        .def_static("LineTraceMulti", [](UObject* worldCtx, FVector& start, FVector& end, int channel, bool isComplex, py::list& _ignore, int debugType, bool ignoreSelf, FLinearColor& traceColor, FLinearColor& hitColor, float drawTime)
+        .def_static("LineTraceMulti", [](UObject* worldCtx, FVector& start, FVector& end, int channel, bool isComplex, py::list& _ignore, int debugType, bool ignoreSelf, FLinearColor& traceColor, FLinearColor& hitColor, float drawTime, bool asList) -> py::object
         {
             TArray<AActor*> ignore;
             for (py::handle h : _ignore)
                 ignore.Emplace(h.cast<AActor*>());
             TArray<FHitResult> hits;
             UKismetSystemLibrary::LineTraceMulti(worldCtx, start, end, (ETraceTypeQuery)channel, isComplex, ignore, (EDrawDebugTrace::Type)debugType, hits, ignoreSelf, traceColor, hitColor, drawTime);
-            py::list retHits;
-            for (auto h : hits)
-                retHits.append(h);
-            return retHits; // if retHits is empty, it means didHit is false, so no need to send it to the caller
-        }, py::return_value_policy::reference, py::arg("worldCtx"), py::arg("start"), py::arg("end"), py::arg("channel"), py::arg("isComplex"), py::arg("_ignore"), py::arg("debugType")=(int)EDrawDebugTrace::None, py::arg("ignoreSelf")=true, py::arg("traceColor")=FLinearColor::Red, py::arg("hitColor")=FLinearColor::Green, py::arg("drawTime")=5.0f)
-        .def_static("LineTraceMultiForObjects", [](UObject* worldCtx, FVector& start, FVector& end, py::list& _objectTypes, bool isComplex, py::list& _ignore, int debugType, bool ignoreSelf, FLinearColor& traceColor, FLinearColor& hitColor, float drawTime)
+            if (asList)
+            {   // the old return type, for callers that need an actual list
+                py::list retHits;
+                for (auto h : hits)
+                    retHits.append(h);
+                return retHits;
+            }
+            // a HitResults acts like a read-only list of the hits but only makes FHitResult wrappers for the ones that get
+            // looked at, and can give the common fields as buffers (it's empty if didHit is false)
+            return py::cast(new FHitResults(MoveTemp(hits)), py::return_value_policy::take_ownership);
+        }, py::arg("worldCtx"), py::arg("start"), py::arg("end"), py::arg("channel"), py::arg("isComplex"), py::arg("_ignore"), py::arg("debugType")=(int)EDrawDebugTrace::None, py::arg("ignoreSelf")=true, py::arg("traceColor")=FLinearColor::Red, py::arg("hitColor")=FLinearColor::Green, py::arg("drawTime")=5.0f, py::arg("asList")=false)
+        .def_static("LineTraceMultiForObjects", [](UObject* worldCtx, FVector& start, FVector& end, py::list& _objectTypes, bool isComplex, py::list& _ignore, int debugType, bool ignoreSelf, FLinearColor& traceColor, FLinearColor& hitColor, float drawTime, bool asList) -> py::object
         {
             TArray<TEnumAsByte<EObjectTypeQuery>> objectTypes;
             for (py::handle h: _objectTypes)
@@ -1635,11 +2055,17 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
                 ignore.Emplace(h.cast<AActor*>());
             TArray<FHitResult> hits;
             UKismetSystemLibrary::LineTraceMultiForObjects(worldCtx, start, end, objectTypes, isComplex, ignore, (EDrawDebugTrace::Type)debugType, hits, ignoreSelf, traceColor, hitColor, drawTime);
-            py::list retHits;
-            for (auto h : hits)
-                retHits.append(h);
-            return retHits; // if retHits is empty, it means didHit is false, so no need to send it to the caller
-        }, py::return_value_policy::reference, py::arg("worldCtx"), py::arg("start"), py::arg("end"), py::arg("objectTypes"), py::arg("isComplex"), py::arg("_ignore"), py::arg("debugType") = (int)EDrawDebugTrace::None, py::arg("ignoreSelf") = true, py::arg("traceColor") = FLinearColor::Red, py::arg("hitColor") = FLinearColor::Green, py::arg("drawTime") = 5.0f)
+            if (asList)
+            {   // the old return type, for callers that need an actual list
+                py::list retHits;
+                for (auto h : hits)
+                    retHits.append(h);
+                return retHits;
+            }
+            // a HitResults acts like a read-only list of the hits but only makes FHitResult wrappers for the ones that get
+            // looked at, and can give the common fields as buffers (it's empty if didHit is false)
+            return py::cast(new FHitResults(MoveTemp(hits)), py::return_value_policy::take_ownership);
+        }, py::arg("worldCtx"), py::arg("start"), py::arg("end"), py::arg("objectTypes"), py::arg("isComplex"), py::arg("_ignore"), py::arg("debugType") = (int)EDrawDebugTrace::None, py::arg("ignoreSelf") = true, py::arg("traceColor") = FLinearColor::Red, py::arg("hitColor") = FLinearColor::Green, py::arg("drawTime") = 5.0f, py::arg("asList") = false)
         .def_static("BoxTraceSingle", [](UObject* worldCtx, FVector& start, FVector& end, FVector& halfSize, FRotator& orientation, int channel, bool isComplex, py::list& _ignore, int debugType, bool ignoreSelf, FLinearColor& traceColor, FLinearColor& hitColor, float drawTime)
         {
             TArray<AActor*> ignore;
@@ -2002,9 +2428,9 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("GetOwner", [](AActor& self) { return self.GetOwner(); }, py::return_value_policy::reference)
         .def("SetOwner", [](AActor& self, AActor *newOwner) { self.SetOwner(newOwner); })
         .def("GetInputAxisValue", [](AActor& self, std::string& axisName) { return self.GetInputAxisValue(FSTR(axisName)); })
-        .def("ActorHasTag", [](AActor& self, std::string& tag) { return self.ActorHasTag(FSTR(tag)); })
-        .def("AddTag", [](AActor& self, std::string& tag) { self.Tags.AddUnique(FName(FSTR(tag))); })
-        .def("RemoveTag", [](AActor& self, std::string& tag) { self.Tags.Remove(FName(FSTR(tag))); })
+        .def("ActorHasTag", [](AActor& self, FName& tag) { return self.ActorHasTag(tag); })
+        .def("AddTag", [](AActor& self, FName& tag) { self.Tags.AddUnique(tag); })
+        .def("RemoveTag", [](AActor& self, FName& tag) { self.Tags.Remove(tag); })
         .def("EnableInput", [](AActor& self, APlayerController* pc) { self.EnableInput(pc); })
         .def("DisableInput", [](AActor& self, APlayerController* pc) { self.DisableInput(pc); })
         .def("SetActorEnableCollision", [](AActor& self, bool enable) { self.SetActorEnableCollision(enable); })
@@ -2013,14 +2439,14 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
             {
                 py::list ret;
                 for (FName& tag : self.Tags)
-                    ret.append(PYSTR(tag.ToString()));
+                    ret.append(tag);
                 return ret;
             },
             [](AActor& self, py::list pytags)
             {
                 self.Tags.Empty();
                 for (const py::handle pytag : pytags)
-                    self.Tags.Emplace(FSTR(pytag.cast<std::string>()));
+                    self.Tags.Emplace(pytag.cast<FName>());
             })
         .def("AttachToActor", [](AActor& self, AActor* parent, std::string& socket)
         {
@@ -2031,7 +2457,9 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
                 socketName = FSTR(socket);
                 rules = FAttachmentTransformRules::SnapToTargetNotIncludingScale;
             }
+            FComponentIndex::InvalidateAttachChain(self.GetRootComponent());
             self.AttachToActor(parent, rules, socketName);
+            FComponentIndex::InvalidateAttachChain(self.GetRootComponent());
         }, py::arg("parent"), py::arg("socket")="")
         .def("GetActorBounds", [](AActor& self, bool bOnlyCollidingComps, bool bIncludeFromChildActors) // returns FVector origin, FVector boxExtent
         {
@@ -2043,31 +2471,47 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         .def("CalculateComponentsBoundingBoxInLocalSpace", [](AActor& self, bool bNonColliding, bool bIncludeFromChildActors) { return self.CalculateComponentsBoundingBoxInLocalSpace(bNonColliding, bIncludeFromChildActors); })
         .def("GetComponentByName", [](AActor& self, std::string& _name, bool incAllDescendents, std::string& suffixSeparator) -> USceneComponent*
         {
-            FString suffixSep = FSTR(suffixSeparator); // see uepy/__init__.py COMPONENT_NAME_SUFFIX_SEPARATOR
-            TArray<USceneComponent*> kids;
             USceneComponent* root = self.GetRootComponent();
             if (!root)
                 return nullptr;
 
-            FString name = FSTR(_name);
-            if (root->GetName() == name)
-                return root;
-
-            root->GetChildrenComponents(incAllDescendents, kids);
-            for (auto kid : kids)
+            // the index covers the actor's own comps as well as other actors' comps attached under our root
+            FComponentIndex* index = FComponentIndex::Get(&self);
+            UActorComponent* found = index->FindByName(FName(FSTR(_name)), FSTR(suffixSeparator), [root, incAllDescendents](UActorComponent* comp)
             {
-                FString kidName = kid->GetName();
-                if (suffixSep.Len())
-                {   // if a suffix separator was provided, caller wants us to strip off the end of the name and just compare against the first part
-                    FString left, right;
-                    if (kidName.Split(suffixSep, &left, &right) && left == name)
-                        return kid;
-                }
-                else if (kidName == name)
-                    return kid;
-            }
-            return nullptr;
+                USceneComponent* sc = Cast<USceneComponent>(comp);
+                if (!sc)
+                    return false;
+                return sc == root || (incAllDescendents ? sc->IsAttachedTo(root) : sc->GetAttachParent() == root);
+            });
+            return (USceneComponent*)found;
         }, py::return_value_policy::reference)
+        .def("GetComponentByNameAndClass", [](AActor& self, FName& name, py::object& _klass, FString& suffixSeparator) -> UActorComponent*
+        {   // finds any component owned by this actor with the given name (minus any suffix) and of the given class
+            UClass* klass = PyObjectToUClass(_klass);
+            if (!klass)
+                return nullptr;
+            FComponentIndex* index = FComponentIndex::Get(&self);
+            return index->FindByName(name, suffixSeparator, [&self, klass](UActorComponent* comp) { return comp->GetOwner() == &self && comp->IsA(klass); });
+        }, py::return_value_policy::reference, "name"_a, "klass"_a, "suffixSeparator"_a="")
+        .def("GetComponentsByTag", [](AActor& self, FName& tag, py::object& _klass)
+        {   // returns a list of all components owned by this actor that have the given tag and (optionally) are of the given class
+            UClass* klass = _klass.is_none() ? nullptr : PyObjectToUClass(_klass);
+            FComponentIndex* index = FComponentIndex::Get(&self);
+            TArray<UActorComponent*> comps;
+            index->FindByTag(tag, [klass](UActorComponent* comp) { return !klass || comp->IsA(klass); }, comps);
+            py::list ret;
+            for (UActorComponent* comp : comps)
+                ret.append(comp);
+            return ret;
+        }, "tag"_a, "klass"_a=py::none())
+        .def("HasComponentWithTag", [](AActor& self, FName& tag)
+        {
+            TArray<UActorComponent*> comps;
+            FComponentIndex::Get(&self)->FindByTag(tag, [](UActorComponent* comp) { return true; }, comps);
+            return comps.Num() > 0;
+        })
+        .def("InvalidateComponentIndex", [](AActor& self) { FComponentIndex::Invalidate(&self); }) // for when comps are renamed, retagged or attached outside of uepy
         ;
 
     py::class_<AController, AActor, UnrealTracker<AController>>(m, "AController")
@@ -2249,7 +2693,7 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         }
 
         FString name = FSTR(fqClassName);
-        pyClassMap[name] = pyClass; // GRR: saving the class to a map because I can't get the lambda below to work with captured arguments
+        pyClassMap[name] = pyClass; // for lookups by name; the class constructor uses pyClassInfo below
 
         UClass *engineClass = FindObject<UClass>(ANY_PACKAGE, *name);
         if (!engineClass)
@@ -2266,25 +2710,44 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         engineClass->ClassWithin = engineParentClass->ClassWithin;
         engineClass->ClassConfigName = engineParentClass->ClassConfigName;
         engineClass->ClassCastFlags = engineParentClass->ClassCastFlags;
+        // the metaclass sets engineClass too, but not until we return, and the CDO gets created below. Setting it now keeps
+        // PyObjectToUClass from resolving (and caching) the new class as whatever class it inherited engineClass from.
+        pyClass.attr("engineClass") = engineClass;
+        InvalidateUClassCache();
+
+        FPyClassInfo& info = pyClassInfo.FindOrAdd(engineClass);
+        info.pyClass = pyClass;
+        info.parentClass = engineParentClass;
         engineClass->ClassConstructor = [](const FObjectInitializer& objInitializer)
         {
             UObject *engineObj = objInitializer.GetObj();
-            UClass *parentClass = engineObj->GetClass()->GetSuperClass();
-            if (parentClass && parentClass->ClassConstructor)
-                parentClass->ClassConstructor(objInitializer);
+            FPyClassInfo* info = _FindPyClassInfo(engineObj->GetClass());
+            if (!info)
+            {
+                LERROR("No Python class registered for %s", *engineObj->GetClass()->GetName());
+                return;
+            }
+            if (info->parentClass->ClassConstructor)
+                info->parentClass->ClassConstructor(objInitializer);
 
             //if (!engineObj->HasAnyFlags(RF_ClassDefaultObject)) // during CDO creation, we don't want to create a pyinst
             // TODO: I have some misgivings about always constructing the CDO object, but without it, we have no way to override some
             // things (such as making the playercontroller always spawn our pawns). If we find undesirable behavior with this, maybe
             // we should someday not use __init__ but split it into Init and CDOInit or something.
+            uint64 start = FPlatformTime::Cycles64();
             try {
-                IUEPYGlueMixin *p = Cast<IUEPYGlueMixin>(engineObj);
-                FString className = engineObj->GetClass()->GetName();
-                py::object& pyClass = pyClassMap[className];
-                py::dict spawnArgs = py::module::import("_uepy").attr("spawnArgs");
-                pyClass(engineObj, **spawnArgs); // the metaclass in uepy.__init__ requires engineObj to be passed as the first param; it gobbles it up and auto-sets self.engineObj on the new instance
-                ClearInternalSpawnArgs();
+                // the metaclass in uepy.__init__ requires engineObj to be passed as the first param; it gobbles it up and auto-sets self.engineObj on the new instance
+                if (internalSpawnArgs)
+                {
+                    py::dict spawnArgs = internalSpawnArgs;
+                    info->pyClass(engineObj, **spawnArgs);
+                }
+                else
+                    info->pyClass(engineObj);
             } catchpy;
+            ClearInternalSpawnArgs();
+            info->numConstructed++;
+            info->constructCycles += FPlatformTime::Cycles64() - start;
         };
 
         // add in any interfaces that this class implements, both from the parent class as well as the python subclass itself
@@ -2319,6 +2782,41 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         return engineClass;
     }, py::return_value_policy::reference);
 
+    // construction stats for Python subclasses: {className:(numConstructed, totalSeconds)}
+    m.def("GetPythonSubclassStats", []()
+    {
+        py::dict ret;
+        for (auto& entry : pyClassInfo)
+            ret[PYSTR(entry.Key->GetName())] = py::make_tuple(entry.Value.numConstructed, FPlatformTime::ToSeconds64(entry.Value.constructCycles));
+        return ret;
+    });
+    m.def("ResetPythonSubclassStats", []()
+    {
+        for (auto& entry : pyClassInfo)
+        {
+            entry.Value.numConstructed = 0;
+            entry.Value.constructCycles = 0;
+        }
+    });
+
+    // (hits, misses, size) of the str --> FName cache used for FName args (see uepy_strings.h)
+    m.def("GetFNameCacheStats", []()
+    {
+        int64 hits, misses;
+        int32 size;
+        GetFNameCacheStats(hits, misses, size);
+        return py::make_tuple(hits, misses, size);
+    });
+
+    // (hits, misses, size) of the Python type --> UClass cache used for class args
+    m.def("GetUClassCacheStats", []()
+    {
+        int64 hits, misses;
+        int32 size;
+        GetUClassCacheStats(hits, misses, size);
+        return py::make_tuple(hits, misses, size);
+    });
+
     // used during class construction to set pyInst
     m.def("InternalSetPyInst", [](UObject* self, py::object& inst)
     {
@@ -2337,47 +2835,168 @@ PYBIND11_EMBEDDED_MODULE(_uepy, m) { // note the _ prefix, the builtin module us
         UClass *actorClass = PyObjectToUClass(_actorClass);
         if (!actorClass)
             return (AActor*)nullptr;
+        return _SpawnActor(world, actorClass, FTransform(rotation, location), kwargs);
+    }, py::arg("world"), py::arg("actorClass"), py::arg("location")=FVector(0,0,0), py::arg("rotation")=FRotator(0,0,0), py::arg("kwargs"), py::return_value_policy::reference);
 
-        if (py::len(kwargs) == 0)
-        {   // one-shot spawn because no extra params were passed
-            FActorSpawnParameters info;
-            info.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-            return world->SpawnActor(actorClass, &location, &rotation, info);
-        }
-        else
-        {   // caller also wants to pass in some params so we need to do a multi-step spawn. If the class is actually a Python subclass of an engine class,
-            // we pass the kwargs directly to the constructor via a bit of hackery. This is both more efficient but, more importantly, it allows us to do
-            // some earlier initialization that is pretty much impossible any other way (assuming you want replication to work right).
-            bool directInit = false;
-            if (pyClassMap.count(actorClass->GetName()))
+    // actor pools - see ActorPool.h
+    py::class_<FActorPool, std::shared_ptr<FActorPool>>(m, "ActorPool")
+        .def("Acquire", [](FActorPool& self, FTransform& transform, py::kwargs& kwargs) -> AActor*
+        {   // returns an idle actor from the pool (or a newly spawned one if there aren't any). kwargs are handled the same
+            // for both: actors with a Python instance get them via OnPoolAcquire(**kwargs), and other actors have them set
+            // as properties.
+            UWorld* world = self.world.Get();
+            UClass* klass = self.klass.Get();
+            if (!world || !klass)
+                throw py::value_error("the pool's world or class has gone away");
+            py::dict kw = kwargs;
+            bool hasPyInst = _FindPyClassInfo(klass) != nullptr;
+            FActorPool::FIdle reused;
+            AActor* actor = nullptr;
+            if (self.PopIdle(reused))
             {
-                directInit = true;
-                SetInternalSpawnArgs(kwargs);
+                actor = reused.actor.Get();
+                if (!hasPyInst)
+                {
+                    for (auto item : kw)
+                    {
+                        std::string k = item.first.cast<std::string>();
+                        py::object v = py::cast<py::object>(item.second);
+                        SetObjectProperty(actor, k, v);
+                    }
+                }
+                self.Activate(actor, transform, kw, &reused);
             }
-
-            FTransform transform(rotation, location);
-            AActor *actor = world->SpawnActorDeferred<AActor>(actorClass, transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-            if (!actor)
+            else
             {
-                LERROR("Failed to spawn actor");
-                ClearInternalSpawnArgs();
-                return (AActor*)nullptr;
+                py::dict spawnKwargs;
+                actor = _SpawnActor(world, klass, transform, hasPyInst ? spawnKwargs : kw);
+                if (actor)
+                    self.Activate(actor, transform, kw, nullptr);
             }
+            return actor;
+        }, py::return_value_policy::reference)
+        .def("Release", [](FActorPool& self, AActor* actor) { self.Release(actor); })
+        .def("Prewarm", [](FActorPool& self, int count, py::kwargs& kwargs)
+        {   // spawns actors until the pool has at least count idle ones. Unlike Acquire's, these kwargs are spawn args, i.e.
+            // they go to __init__ for Python subclasses, and every prewarmed actor gets all of them.
+            UWorld* world = self.world.Get();
+            UClass* klass = self.klass.Get();
+            if (!world || !klass)
+                throw py::value_error("the pool's world or class has gone away");
+            py::dict kw = kwargs;
+            while (self.NumIdle() < count)
+            {
+                AActor* actor = _SpawnActor(world, klass, FTransform::Identity, kw);
+                if (!actor)
+                    break;
+                self.numSpawned++;
+                self.Release(actor, true);
+            }
+        }, "count"_a)
+        .def("DestroyIdle", [](FActorPool& self) { self.DestroyIdle(); })
+        .def_property_readonly("numIdle", [](FActorPool& self) { return self.NumIdle(); })
+        .def_property_readonly("stats", [](FActorPool& self)
+        {
+            py::dict ret;
+            ret["idle"] = self.NumIdle();
+            ret["spawned"] = self.numSpawned;
+            ret["acquired"] = self.numAcquired;
+            ret["reused"] = self.numReused;
+            ret["released"] = self.numReleased;
+            return ret;
+        })
+        ;
+    m.def("GetActorPool", [](UWorld* world, py::object& _klass)
+    {   // the pool lives until its world is cleaned up (see ActorPool.h)
+        UClass* klass = PyObjectToUClass(_klass);
+        if (!klass || !klass->IsChildOf(AActor::StaticClass()))
+            throw py::type_error("klass must be an actor class");
+        if (!VALID(world))
+            throw py::value_error("invalid world");
+        return FActorPool::Get(world, klass);
+    });
 
-            if (!directInit)
-            {   // fall back to the engine way of two-step init
-                for (auto item : kwargs)
-                {
-                    std::string k = item.first.cast<std::string>();
-                    py::object v = py::cast<py::object>(item.second);
-                    SetObjectProperty(actor, k, v);
-                }
+    // Spawns lots of actors of the same class in one call. transforms is a float32 buffer with one row per actor, where
+    // the row width picks the layout: 3 (location), 6 (location, pitch/yaw/roll), 7 (location, quat xyzw), or 10 (location,
+    // quat, scale); a 1D buffer is treated as 10 wide. sharedKwargs go to every actor and perInstanceKwargs, if given, is a
+    // list with a dict per actor. Returns an int64 buffer of actor handles (see UObjectFromHandle; 0 = failed). An actor that
+    // fails to spawn (e.g. because of a bad kwarg) is logged and gets a 0 handle, but doesn't stop the rest of the batch.
+    // If frameBudgetMs > 0, spawning is spread across frames, using at most about that much time per frame, and instead
+    // of returning the handles, callback(handles) is called once they have all been spawned.
+    m.def("SpawnActors", [](UWorld* world, py::object& _klass, py::object& _transforms, py::dict& sharedKwargs, py::object& perInstanceKwargs, float frameBudgetMs, py::object& callback) -> py::object
+    {
+        UClass* klass = PyObjectToUClass(_klass);
+        if (!klass || !klass->IsChildOf(AActor::StaticClass()))
+            throw py::type_error("klass must be an actor class");
+        if (!VALID(world))
+            throw py::value_error("invalid world");
+        if (frameBudgetMs > 0 && callback.is_none())
+            throw py::value_error("a callback is required when using frameBudgetMs");
+
+        int32 width = 10;
+        if (py::isinstance<py::buffer>(_transforms))
+        {
+            py::buffer_info info = py::reinterpret_borrow<py::buffer>(_transforms).request();
+            if (info.ndim == 2)
+                width = (int32)info.shape[1];
+        }
+        if (width != 3 && width != 6 && width != 7 && width != 10)
+            throw py::value_error("transforms must have 3, 6, 7, or 10 values per row");
+        FPyBufferIn<float> rows(_transforms, width, "transforms");
+        if (!perInstanceKwargs.is_none() && py::len(perInstanceKwargs) != rows.count)
+            throw py::value_error("perInstanceKwargs must have one entry per transform");
+
+        TSharedPtr<FSpawnBatch> batch = MakeShared<FSpawnBatch>();
+        batch->world = world;
+        batch->klass = klass;
+        batch->directInit = _IsPythonSubclass(klass);
+        batch->sharedKwargs = sharedKwargs;
+        batch->perInstanceKwargs = perInstanceKwargs;
+        batch->transforms.Reserve(rows.count);
+        batch->handles.Reserve(rows.count);
+        for (int32 i=0; i < rows.count; i++)
+        {
+            const float* p = rows[i];
+            FVector loc(p[0], p[1], p[2]);
+            if (width == 3)
+                batch->transforms.Emplace(loc);
+            else if (width == 6)
+                batch->transforms.Emplace(FRotator(p[3], p[4], p[5]), loc);
+            else if (width == 7)
+                batch->transforms.Emplace(FQuat(p[3], p[4], p[5], p[6]), loc);
+            else
+                batch->transforms.Emplace(FQuat(p[3], p[4], p[5], p[6]), loc, FVector(p[7], p[8], p[9]));
+        }
+        if (!batch->directInit)
+        {   // look up the shared properties just once for the whole batch
+            for (auto item : sharedKwargs)
+            {
+                std::string _name = item.first.cast<std::string>();
+                FProperty* prop = batch->FindProp(klass, FSTR(_name));
+                if (prop)
+                    batch->sharedProps.Emplace(prop, py::reinterpret_borrow<py::object>(item.second));
             }
+        }
 
-            UGameplayStatics::FinishSpawningActor(actor, transform);
-            return actor;
+        if (frameBudgetMs <= 0)
+        {
+            batch->Step(0);
+            return MakePyBuffer(batch->handles.GetData(), batch->handles.Num());
         }
-    }, py::arg("world"), py::arg("actorClass"), py::arg("location")=FVector(0,0,0), py::arg("rotation")=FRotator(0,0,0), py::arg("kwargs"), py::return_value_policy::reference);
+
+        double budget = frameBudgetMs / 1000.0;
+        FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([batch, budget, callback](float dt)
+        {
+            bool done = true;
+            try {
+                done = batch->Step(FPlatformTime::Seconds() + budget);
+                if (done)
+                    callback(MakePyBuffer(batch->handles.GetData(), batch->handles.Num()));
+            } catchpy;
+            return !done; // true = keep going next frame
+        }));
+        return py::none();
+    }, "world"_a, "klass"_a, "transforms"_a, "sharedKwargs"_a=py::dict(), "perInstanceKwargs"_a=py::none(), "frameBudgetMs"_a=0.0f, "callback"_a=py::none());
 
     m.def("NewObject_", [](py::object& _class, UObject *owner, std::string& name, py::dict kwargs) // underscore suffix because there is a Python NewObject function that calls it
     {
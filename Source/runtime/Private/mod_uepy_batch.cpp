@@ -0,0 +1,1272 @@
+#include "mod_uepy_batch.h"
+#include "common.h"
+#include "SpatialIndex.h"
+#include "TickLOD.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "NiagaraComponent.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "NiagaraUserRedirectionParameterStore.h"
+
+using namespace pybind11::literals;
+
+//#pragma optimize("", off)
+
+void FTraceBatchResults::Reset(int32 count)
+{
+    hit.SetNumZeroed(count);
+    distance.SetNumZeroed(count);
+    location.SetNumZeroed(count);
+    normal.SetNumZeroed(count);
+    actorIndex.Init(-1, count);
+    actors.Reset();
+    actorToIndex.Reset();
+}
+
+void FTraceBatchResults::Set(int32 i, const FHitResult& hitResult)
+{
+    hit[i] = hitResult.bBlockingHit ? 1 : 0;
+    distance[i] = hitResult.Distance;
+    location[i] = hitResult.Location;
+    normal[i] = hitResult.Normal;
+
+    AActor* actor = hitResult.GetActor();
+    if (actor)
+    {
+        int32* existing = actorToIndex.Find(actor);
+        if (existing)
+            actorIndex[i] = *existing;
+        else
+        {
+            actorIndex[i] = actors.Emplace(actor);
+            actorToIndex.Add(actor, actorIndex[i]);
+        }
+    }
+}
+
+int32 FTraceBatchResults::NumHits() const
+{
+    int32 num = 0;
+    for (uint8 h : hit)
+        num += h;
+    return num;
+}
+
+void FQueryBatchResults::AddEntry(AActor* actor, UPrimitiveComponent* comp)
+{
+    int32 ai = -1;
+    if (actor)
+    {
+        int32* existing = actorToIndex.Find(actor);
+        ai = existing ? *existing : actorToIndex.Add(actor, actors.Emplace(actor));
+    }
+    int32 ci = -1;
+    if (comp)
+    {
+        int32* existing = componentToIndex.Find(comp);
+        ci = existing ? *existing : componentToIndex.Add(comp, components.Emplace(comp));
+    }
+    actorIndex.Emplace(ai);
+    componentIndex.Emplace(ci);
+}
+
+// a per-query float arg that can be given as a single number or as a buffer with one value per query
+struct FPerQueryFloat
+{
+    float single = 0.0f;
+    TUniquePtr<FPyBufferIn<float>> values;
+
+    FPerQueryFloat(py::object& obj, int32 count, const char* what)
+    {
+        if (py::isinstance<py::float_>(obj) || py::isinstance<py::int_>(obj))
+            single = obj.cast<float>();
+        else
+        {
+            values = MakeUnique<FPyBufferIn<float>>(obj, 1, what);
+            if (values->count != count)
+                throw py::value_error(std::string(what) + " must be a single number or have one value per query");
+        }
+    }
+    float operator[](int32 i) const { return values ? values->data[i] : single; }
+};
+
+// a per-query vector arg (stride 3 or 4) given as a buffer holding either one value or one per query
+struct FPerQueryVector
+{
+    FPyBufferIn<float> values;
+
+    FPerQueryVector(py::object& obj, int32 stride, int32 count, const char* what) : values(obj, stride, what)
+    {
+        if (values.count != 1 && values.count != count)
+            throw py::value_error(std::string(what) + " must have either one value or one value per query");
+    }
+    const float* operator[](int32 i) const { return values[values.count == 1 ? 0 : i]; }
+};
+
+FQueryBatchResults* OverlapSphereBatch(UWorld* world, py::object& _centers, py::object& _radii, int channel, py::object& params)
+{
+    if (!VALID(world))
+        throw py::value_error("invalid world");
+    FPyBufferIn<float> centers(_centers, 3, "centers");
+    FPerQueryFloat radii(_radii, centers.count, "radii");
+    FTraceQuery scratch;
+    FTraceQuery* query = _TraceQueryFromPy(params, scratch);
+    query->GetParams();
+
+    FQueryBatchResults* results = new FQueryBatchResults();
+    {
+        py::gil_scoped_release release;
+        TArray<FOverlapResult> overlaps;
+        for (int32 i=0; i < centers.count; i++)
+        {
+            results->BeginQuery();
+            overlaps.Reset();
+            query->OverlapMulti(world, overlaps, centers.GetVector(i), FQuat::Identity, FCollisionShape::MakeSphere(radii[i]), channel);
+            for (FOverlapResult& o : overlaps)
+                results->AddEntry(o.GetActor(), o.GetComponent());
+        }
+        results->EndBatch();
+    }
+    return results;
+}
+
+FQueryBatchResults* OverlapBoxBatch(UWorld* world, py::object& _centers, py::object& _extents, py::object& _rotations, int channel, py::object& params)
+{
+    if (!VALID(world))
+        throw py::value_error("invalid world");
+    FPyBufferIn<float> centers(_centers, 3, "centers");
+    FPerQueryVector extents(_extents, 3, centers.count, "extents");
+    TUniquePtr<FPerQueryVector> rotations; // quaternions as xyzw, or None for no rotation
+    if (!_rotations.is_none())
+        rotations = MakeUnique<FPerQueryVector>(_rotations, 4, centers.count, "rotations");
+    FTraceQuery scratch;
+    FTraceQuery* query = _TraceQueryFromPy(params, scratch);
+    query->GetParams();
+
+    FQueryBatchResults* results = new FQueryBatchResults();
+    {
+        py::gil_scoped_release release;
+        TArray<FOverlapResult> overlaps;
+        for (int32 i=0; i < centers.count; i++)
+        {
+            results->BeginQuery();
+            overlaps.Reset();
+            const float* e = extents[i];
+            FQuat rot = FQuat::Identity;
+            if (rotations)
+            {
+                const float* r = (*rotations)[i];
+                rot = FQuat(r[0], r[1], r[2], r[3]);
+            }
+            query->OverlapMulti(world, overlaps, centers.GetVector(i), rot, FCollisionShape::MakeBox(FVector(e[0], e[1], e[2])), channel);
+            for (FOverlapResult& o : overlaps)
+                results->AddEntry(o.GetActor(), o.GetComponent());
+        }
+        results->EndBatch();
+    }
+    return results;
+}
+
+FQueryBatchResults* SweepBatch(UWorld* world, py::object& _starts, py::object& _ends, py::object& _radii, int channel, py::object& params)
+{
+    if (!VALID(world))
+        throw py::value_error("invalid world");
+    FPyBufferIn<float> starts(_starts, 3, "starts");
+    FPyBufferIn<float> ends(_ends, 3, "ends");
+    if (starts.count != ends.count)
+        throw py::value_error("starts and ends must have the same number of points");
+    FPerQueryFloat radii(_radii, starts.count, "radii");
+    FTraceQuery scratch;
+    FTraceQuery* query = _TraceQueryFromPy(params, scratch);
+    query->GetParams();
+
+    FQueryBatchResults* results = new FQueryBatchResults();
+    {
+        py::gil_scoped_release release;
+        TArray<FHitResult> hits;
+        for (int32 i=0; i < starts.count; i++)
+        {
+            results->BeginQuery();
+            hits.Reset();
+            query->SweepMulti(world, hits, starts.GetVector(i), ends.GetVector(i), FQuat::Identity, FCollisionShape::MakeSphere(radii[i]), channel);
+            for (FHitResult& h : hits)
+            {
+                results->AddEntry(h.GetActor(), h.GetComponent());
+                results->distance.Emplace(h.Distance);
+                results->location.Emplace(h.Location);
+            }
+        }
+        results->EndBatch();
+    }
+    return results;
+}
+
+const FHitResult& FHitResults::Get(int32 i) const
+{
+    if (i < 0)
+        i += hits.Num();
+    if (i < 0 || i >= hits.Num())
+        throw py::index_error("hit index out of range");
+    return hits[i];
+}
+
+// copies one vector field out of each hit into a (N,3) float buffer
+template<typename F>
+py::object _HitVectorsToBuffer(const TArray<FHitResult>& hits, F getter)
+{
+    TArray<float> values;
+    values.SetNumUninitialized(hits.Num() * 3);
+    float* p = values.GetData();
+    for (const FHitResult& h : hits)
+    {
+        const FVector& v = getter(h);
+        *p++ = v.X; *p++ = v.Y; *p++ = v.Z;
+    }
+    return MakePyBuffer(values.GetData(), hits.Num(), 3);
+}
+
+FTraceQuery::FTraceQuery() : params(FName(TEXT("uepyTraceQuery")), false)
+{
+}
+
+void FTraceQuery::SetObjectTypes(const TArray<int32>& types)
+{
+    objectTypes = types;
+    objectParams = FCollisionObjectQueryParams();
+    for (int32 type : objectTypes)
+        objectParams.AddObjectTypesToQuery((ECollisionChannel)type);
+}
+
+void FTraceQuery::AddIgnoredActor(AActor* actor)
+{
+    if (!actor || ignoredActors.Contains(actor))
+        return;
+    ignoredActors.Emplace(actor);
+    params.AddIgnoredActor(actor);
+}
+
+void FTraceQuery::RemoveIgnoredActor(AActor* actor)
+{
+    if (ignoredActors.Remove(actor) > 0)
+        ignoresDirty = true; // the engine params don't support removal, so rebuild them lazily on next use
+}
+
+void FTraceQuery::ClearIgnoredActors()
+{
+    ignoredActors.Reset();
+    params.ClearIgnoredActors();
+}
+
+void FTraceQuery::AddIgnoredComponent(UPrimitiveComponent* comp)
+{
+    if (!comp || ignoredComponents.Contains(comp))
+        return;
+    ignoredComponents.Emplace(comp);
+    params.AddIgnoredComponent(comp);
+}
+
+void FTraceQuery::RemoveIgnoredComponent(UPrimitiveComponent* comp)
+{
+    if (ignoredComponents.Remove(comp) > 0)
+        ignoresDirty = true;
+}
+
+void FTraceQuery::ClearIgnoredComponents()
+{
+    ignoredComponents.Reset();
+    params.ClearIgnoredComponents();
+}
+
+const FCollisionQueryParams& FTraceQuery::GetParams()
+{
+    if (ignoresDirty)
+    {
+        ignoresDirty = false;
+        params.ClearIgnoredActors();
+        params.ClearIgnoredComponents();
+        ignoredActors.RemoveAll([](const TWeakObjectPtr<AActor>& a) { return !a.IsValid(); });
+        ignoredComponents.RemoveAll([](const TWeakObjectPtr<UPrimitiveComponent>& c) { return !c.IsValid(); });
+        for (TWeakObjectPtr<AActor>& a : ignoredActors)
+            params.AddIgnoredActor(a.Get());
+        for (TWeakObjectPtr<UPrimitiveComponent>& c : ignoredComponents)
+            params.AddIgnoredComponent(c.Get());
+    }
+    return params;
+}
+
+bool FTraceQuery::LineTraceSingle(UWorld* world, FHitResult& outHit, const FVector& start, const FVector& end, int channelOverride)
+{
+    if (UsesObjectTypes())
+        return world->LineTraceSingleByObjectType(outHit, start, end, objectParams, GetParams());
+    return world->LineTraceSingleByChannel(outHit, start, end, channelOverride >= 0 ? (ECollisionChannel)channelOverride : channel, GetParams());
+}
+
+bool FTraceQuery::LineTraceMulti(UWorld* world, TArray<FHitResult>& outHits, const FVector& start, const FVector& end, int channelOverride)
+{
+    if (UsesObjectTypes())
+        return world->LineTraceMultiByObjectType(outHits, start, end, objectParams, GetParams());
+    return world->LineTraceMultiByChannel(outHits, start, end, channelOverride >= 0 ? (ECollisionChannel)channelOverride : channel, GetParams());
+}
+
+bool FTraceQuery::SweepSingle(UWorld* world, FHitResult& outHit, const FVector& start, const FVector& end, const FQuat& rot, const FCollisionShape& shape, int channelOverride)
+{
+    if (UsesObjectTypes())
+        return world->SweepSingleByObjectType(outHit, start, end, rot, objectParams, shape, GetParams());
+    return world->SweepSingleByChannel(outHit, start, end, rot, channelOverride >= 0 ? (ECollisionChannel)channelOverride : channel, shape, GetParams());
+}
+
+bool FTraceQuery::SweepMulti(UWorld* world, TArray<FHitResult>& outHits, const FVector& start, const FVector& end, const FQuat& rot, const FCollisionShape& shape, int channelOverride)
+{
+    if (UsesObjectTypes())
+        return world->SweepMultiByObjectType(outHits, start, end, rot, objectParams, shape, GetParams());
+    return world->SweepMultiByChannel(outHits, start, end, rot, channelOverride >= 0 ? (ECollisionChannel)channelOverride : channel, shape, GetParams());
+}
+
+bool FTraceQuery::OverlapMulti(UWorld* world, TArray<FOverlapResult>& outOverlaps, const FVector& pos, const FQuat& rot, const FCollisionShape& shape, int channelOverride)
+{
+    if (UsesObjectTypes())
+        return world->OverlapMultiByObjectType(outOverlaps, pos, rot, objectParams, shape, GetParams());
+    return world->OverlapMultiByChannel(outOverlaps, pos, rot, channelOverride >= 0 ? (ECollisionChannel)channelOverride : channel, shape, GetParams());
+}
+
+FTraceQuery* _TraceQueryFromPy(const py::object& params, FTraceQuery& scratch)
+{
+    if (params.is_none())
+        return &scratch;
+
+    if (py::isinstance<FTraceQuery>(params))
+        return params.cast<FTraceQuery*>();
+
+    if (py::isinstance<py::list>(params) || py::isinstance<py::tuple>(params))
+    {
+        for (py::handle h : params)
+            scratch.AddIgnoredActor(h.cast<AActor*>());
+        return &scratch;
+    }
+
+    throw py::type_error("params must be a TraceQuery, None, or a list of actors to ignore");
+}
+
+FName _NiagaraNameFromPy(const py::object& nameOrHandle)
+{
+    if (py::isinstance<FNiagaraParamHandle>(nameOrHandle))
+        return nameOrHandle.cast<FNiagaraParamHandle&>().name;
+    std::string name = nameOrHandle.cast<std::string>();
+    return FName(FSTR(name));
+}
+
+int32 FNiagaraParamHandle::FindOffset(UNiagaraComponent* comp, const FNiagaraTypeDefinition& type)
+{
+    FNiagaraUserRedirectionParameterStore& store = comp->GetOverrideParameters();
+    TArrayView<const FNiagaraVariableWithOffset> vars = store.ReadParameterVariables();
+    FObjectKey key(comp);
+    FLocation* loc = locations.Find(key);
+    if (loc && vars.IsValidIndex(loc->index))
+    {
+        const FNiagaraVariableWithOffset& v = vars[loc->index];
+        if (v.Offset == loc->offset && v.GetName() == loc->storeName && v.GetType() == type)
+            return loc->offset;
+    }
+
+    // not seen before, or the store has changed since
+    int32 offset = store.IndexOf(FNiagaraVariable(type, name)); // this handles the User. prefix for us
+    int32 index = offset == INDEX_NONE ? INDEX_NONE : vars.IndexOfByPredicate([offset](const FNiagaraVariableWithOffset& v) { return v.Offset == offset; });
+    if (index == INDEX_NONE)
+    {
+        locations.Remove(key);
+        return INDEX_NONE;
+    }
+    if (!loc)
+    {
+        _PruneDeadKeys(locations, pruneAt);
+        loc = &locations.Add(key);
+    }
+    loc->storeName = vars[index].GetName();
+    loc->index = index;
+    loc->offset = offset;
+    return offset;
+}
+
+// sets a numeric Niagara param via a handle, falling back to the component's own setter (which adds the param if it
+// doesn't exist yet) when the handle doesn't know where it is. Note that the fast path doesn't record an editor override
+// the way UNiagaraComponent::SetVariable* does in editor builds, which only matters for components being edited in the
+// level editor.
+template<typename T, typename F>
+static void _SetNiagaraParam(FNiagaraParamHandle& handle, UNiagaraComponent* comp, const FNiagaraTypeDefinition& type, const T& value, F fallback)
+{
+    if (!VALID(comp))
+        return;
+    int32 offset = handle.FindOffset(comp, type);
+    if (offset == INDEX_NONE)
+        fallback(comp, handle.name, value);
+    else
+        comp->GetOverrideParameters().SetParameterData((const uint8*)&value, offset, sizeof(T));
+}
+
+// copies a Python buffer into a TArray of T, where each T is made up of some number of V values (e.g. FVector is 3 floats)
+template<typename T, typename V>
+static void _BufferToArray(py::object& values, TArray<T>& out)
+{
+    static_assert(sizeof(T) % sizeof(V) == 0, "T must be made up of V values");
+    FPyBufferIn<V> buffer(values, sizeof(T) / sizeof(V), "values");
+    out.SetNumUninitialized(buffer.count);
+    FMemory::Memcpy(out.GetData(), buffer.data, buffer.count * sizeof(T));
+}
+
+void SetNiagaraArrayFloat(UNiagaraComponent* comp, py::object& name, py::object& values)
+{
+    TArray<float> data;
+    _BufferToArray<float, float>(values, data);
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayFloat(comp, _NiagaraNameFromPy(name), data);
+}
+
+void SetNiagaraArrayVector(UNiagaraComponent* comp, py::object& name, py::object& values)
+{
+    TArray<FVector> data;
+    _BufferToArray<FVector, float>(values, data);
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(comp, _NiagaraNameFromPy(name), data);
+}
+
+void SetNiagaraArrayColor(UNiagaraComponent* comp, py::object& name, py::object& values)
+{
+    TArray<FLinearColor> data;
+    _BufferToArray<FLinearColor, float>(values, data);
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayColor(comp, _NiagaraNameFromPy(name), data);
+}
+
+void SetNiagaraArrayInt32(UNiagaraComponent* comp, py::object& name, py::object& values)
+{
+    TArray<int32> data;
+    _BufferToArray<int32, int32>(values, data);
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayInt32(comp, _NiagaraNameFromPy(name), data);
+}
+
+void FMaterialParamHandle::SetScalar(UMaterialInstanceDynamic* mid, float value)
+{
+    FObjectKey key(mid);
+    int32* index = scalarIndices.Find(key);
+    if (index && mid->ScalarParameterValues.IsValidIndex(*index) && mid->ScalarParameterValues[*index].ParameterInfo.Name == name)
+    {
+        mid->SetScalarParameterByIndex(*index, value);
+        return;
+    }
+
+    // first time on this MID (or the cached index went stale)
+    int32 newIndex = INDEX_NONE;
+    mid->InitializeScalarParameterAndGetIndex(name, value, newIndex);
+    if (newIndex == INDEX_NONE)
+        scalarIndices.Remove(key);
+    else
+    {
+        if (!index)
+            _PruneDeadKeys(scalarIndices, scalarPruneAt);
+        scalarIndices.Add(key, newIndex);
+    }
+}
+
+void FMaterialParamHandle::SetVector(UMaterialInstanceDynamic* mid, const FLinearColor& value)
+{
+    FObjectKey key(mid);
+    int32* index = vectorIndices.Find(key);
+    if (index && mid->VectorParameterValues.IsValidIndex(*index) && mid->VectorParameterValues[*index].ParameterInfo.Name == name)
+    {
+        mid->SetVectorParameterByIndex(*index, value);
+        return;
+    }
+
+    int32 newIndex = INDEX_NONE;
+    mid->InitializeVectorParameterAndGetIndex(name, value, newIndex);
+    if (newIndex == INDEX_NONE)
+        vectorIndices.Remove(key);
+    else
+    {
+        if (!index)
+            _PruneDeadKeys(vectorIndices, vectorPruneAt);
+        vectorIndices.Add(key, newIndex);
+    }
+}
+
+void SetOverrideMaterial(UMeshComponent* self, UMaterialInterface* newMat) // TODO: I think override mode is broken for SMC when we dynamically switch meshes
+{
+    int matCount = self->GetNumMaterials();
+    FPyObjectTracker* tracker = FPyObjectTracker::Get();
+    MaterialArray* origMats = tracker->matOverrideMeshComps.Find(self);
+    if (newMat)
+    {   // caller passed a material, so they want to begin overriding
+        if (!origMats) // if we're already overriding, we've already saved the original materials, so we don't want to stomp them
+        {
+            MaterialArray mats;
+            mats.SetNumZeroed(matCount);
+            for (int i=0; i < matCount; i++)
+            {
+                mats[i] = self->GetMaterial(i); // remember the old
+                self->SetMaterial(i, newMat); // use the override
+            }
+            tracker->matOverrideMeshComps.Emplace(self, mats);
+        }
+    }
+    else if (origMats)
+    {   // leaving override mode, so restore the original mats
+        for (int i=0; i < matCount; i++)
+            self->SetMaterial(i, origMats->GetData()[i]);
+        tracker->matOverrideMeshComps.Remove(self);
+    }
+}
+
+// helper for the batched component setters: calls func(comp, value) for each valid comp in comps, where values is either a
+// single Python value applied to every comp, or a buffer of V with one entry per comp
+template<typename C, typename V, typename F>
+static void _ForEachComponentValue(py::list& comps, py::object& values, F func)
+{
+    int32 numComps = (int32)comps.size();
+    bool single = !py::isinstance<py::buffer>(values);
+    V singleValue = single ? values.cast<V>() : V();
+    TUniquePtr<FPyBufferIn<V>> buffer;
+    if (!single)
+    {
+        buffer = MakeUnique<FPyBufferIn<V>>(values, 1, "values");
+        if (buffer->count != numComps)
+            throw py::value_error("need one value per component");
+    }
+
+    int32 i = 0;
+    for (py::handle h : comps)
+    {
+        C* comp = h.cast<C*>();
+        if (VALID(comp))
+            func(comp, single ? singleValue : buffer->data[i]);
+        i++;
+    }
+}
+
+// returns query results either as a list of actors or, if asIDs is true, as an int32 buffer of entry ids
+static py::object _SpatialResults(FSpatialIndex& index, TArray<int32>& ids, bool asIDs)
+{
+    if (asIDs)
+        return MakePyBuffer(ids.GetData(), ids.Num());
+    py::list ret;
+    for (int32 id : ids)
+    {
+        AActor* actor = index.GetActor(id);
+        if (actor)
+            ret.append(py::cast(actor, py::return_value_policy::reference));
+    }
+    return ret;
+}
+
+// runs a query for each of many inputs in parallel, with the GIL released, and returns CSR-style (offsets, ids) buffers
+// where the results for query i are ids[offsets[i]:offsets[i+1]]
+template<typename F>
+py::tuple _ParallelQueries(int32 count, F query)
+{
+    TArray<TArray<int32>> perQuery;
+    perQuery.SetNum(count);
+    FUEPyKernels::ParallelFor(count, [&](int32 i) { query(i, perQuery[i]); });
+
+    TArray<int32> offsets;
+    offsets.SetNumUninitialized(count+1);
+    int32 total = 0;
+    for (int32 i=0; i < count; i++)
+    {
+        offsets[i] = total;
+        total += perQuery[i].Num();
+    }
+    offsets[count] = total;
+    TArray<int32> flat;
+    flat.Reserve(total);
+    for (TArray<int32>& results : perQuery)
+        flat.Append(results);
+    return py::make_tuple(MakePyBuffer(offsets.GetData(), offsets.Num()), MakePyBuffer(flat.GetData(), flat.Num()));
+}
+
+// state for a batch of async line traces. The engine calls our delegate once per trace at the start of the next frame,
+// and we wait until they've all come in before calling Python once with all of the results. If the world is cleaned up
+// before that happens, the remaining traces will never come in, so the callback gets None instead.
+struct FAsyncTraceBatch
+{
+    FTraceBatchResults results;
+    int32 remaining = 0;
+    py::object callback;
+    TWeakObjectPtr<UWorld> world;
+    FDelegateHandle cleanupHandle;
+
+    // hands the results (or None if abandoned) to Python, which takes ownership of them. Does nothing after the first call.
+    void Deliver(bool abandoned)
+    {
+        if (cleanupHandle.IsValid())
+        {
+            FWorldDelegates::OnWorldCleanup.Remove(cleanupHandle);
+            cleanupHandle.Reset();
+        }
+        if (!callback || callback.is_none())
+            return;
+        py::object cb = callback;
+        callback = py::none(); // don't wait for the shared ptr to go away to release the Python callback
+        try {
+            if (abandoned)
+                cb(py::none());
+            else
+                cb(py::cast(new FTraceBatchResults(MoveTemp(results)), py::return_value_policy::take_ownership));
+        } catchpy;
+    }
+};
+
+// called on pre engine init
+void _LoadModuleBatch(py::module& uepy)
+{
+    LOG("Adding batch APIs to uepy");
+    py::module& m = uepy;
+
+    py::class_<FTraceBatchResults>(m, "TraceBatchResults")
+        .def("__len__", [](FTraceBatchResults& self) { return self.hit.Num(); })
+        .def_property_readonly("count", [](FTraceBatchResults& self) { return self.hit.Num(); })
+        .def_property_readonly("numHits", [](FTraceBatchResults& self) { return self.NumHits(); })
+        .def_property_readonly("hit", [](FTraceBatchResults& self) { return MakePyBuffer(self.hit.GetData(), self.hit.Num()); })
+        .def_property_readonly("distance", [](FTraceBatchResults& self) { return MakePyBuffer(self.distance.GetData(), self.distance.Num()); })
+        .def_property_readonly("location", [](FTraceBatchResults& self) { return MakePyBuffer((float*)self.location.GetData(), self.location.Num(), 3); })
+        .def_property_readonly("normal", [](FTraceBatchResults& self) { return MakePyBuffer((float*)self.normal.GetData(), self.normal.Num(), 3); })
+        .def_property_readonly("actorIndex", [](FTraceBatchResults& self) { return MakePyBuffer(self.actorIndex.GetData(), self.actorIndex.Num()); })
+        .def_property_readonly("actors", [](FTraceBatchResults& self)
+        {   // actors that have since been destroyed come back as None so that actorIndex values stay correct
+            py::list ret;
+            for (TWeakObjectPtr<AActor>& actor : self.actors)
+            {
+                if (actor.IsValid())
+                    ret.append(actor.Get());
+                else
+                    ret.append(py::none());
+            }
+            return ret;
+        }, py::return_value_policy::reference)
+        .def("GetActor", [](FTraceBatchResults& self, int i) -> AActor*
+        {
+            if (i < 0 || i >= self.actorIndex.Num() || self.actorIndex[i] < 0)
+                return nullptr;
+            return self.actors[self.actorIndex[i]].Get();
+        }, py::return_value_policy::reference)
+        ;
+
+    py::class_<FQueryBatchResults>(m, "QueryBatchResults")
+        .def("__len__", [](FQueryBatchResults& self) { return self.NumQueries(); })
+        .def_property_readonly("numEntries", [](FQueryBatchResults& self) { return self.actorIndex.Num(); })
+        .def_property_readonly("offsets", [](FQueryBatchResults& self) { return MakePyBuffer(self.offsets.GetData(), self.offsets.Num()); })
+        .def_property_readonly("actorIndex", [](FQueryBatchResults& self) { return MakePyBuffer(self.actorIndex.GetData(), self.actorIndex.Num()); })
+        .def_property_readonly("componentIndex", [](FQueryBatchResults& self) { return MakePyBuffer(self.componentIndex.GetData(), self.componentIndex.Num()); })
+        .def_property_readonly("distance", [](FQueryBatchResults& self) { return MakePyBuffer(self.distance.GetData(), self.distance.Num()); })
+        .def_property_readonly("location", [](FQueryBatchResults& self) { return MakePyBuffer((float*)self.location.GetData(), self.location.Num(), 3); })
+        .def_property_readonly("actors", [](FQueryBatchResults& self)
+        {   // objects that have since gone away come back as None so that indices stay correct
+            py::list ret;
+            for (TWeakObjectPtr<AActor>& a : self.actors)
+                ret.append(a.IsValid() ? py::cast(a.Get(), py::return_value_policy::reference) : py::none());
+            return ret;
+        })
+        .def_property_readonly("components", [](FQueryBatchResults& self)
+        {
+            py::list ret;
+            for (TWeakObjectPtr<UPrimitiveComponent>& c : self.components)
+                ret.append(c.IsValid() ? py::cast(c.Get(), py::return_value_policy::reference) : py::none());
+            return ret;
+        })
+        .def("GetActors", [](FQueryBatchResults& self, int query)
+        {   // the unique actors found by a single query
+            if (query < 0 || query >= self.NumQueries())
+                throw py::index_error("query index out of range");
+            py::list ret;
+            TSet<int32> seen;
+            for (int32 i=self.offsets[query]; i < self.offsets[query+1]; i++)
+            {
+                int32 ai = self.actorIndex[i];
+                if (ai < 0 || seen.Contains(ai))
+                    continue;
+                seen.Add(ai);
+                AActor* actor = self.actors[ai].Get();
+                if (actor)
+                    ret.append(py::cast(actor, py::return_value_policy::reference));
+            }
+            return ret;
+        })
+        ;
+
+    py::class_<FHitResults>(m, "HitResults")
+        .def("__len__", [](FHitResults& self) { return self.hits.Num(); })
+        .def("__getitem__", [](FHitResults& self, int i) { return self.Get(i); })
+        .def("__iter__", [](FHitResults& self) { return py::make_iterator(self.hits.GetData(), self.hits.GetData() + self.hits.Num()); }, py::keep_alive<0,1>())
+        .def("__repr__", [](FHitResults& self) { return py::str("<HitResults ({} hits)>").format(self.hits.Num()); })
+        .def("GetActor", [](FHitResults& self, int i) { return self.Get(i).GetActor(); }, py::return_value_policy::reference)
+        .def("GetComponent", [](FHitResults& self, int i) { return self.Get(i).GetComponent(); }, py::return_value_policy::reference)
+        .def("GetLocation", [](FHitResults& self, int i) { FVector v = self.Get(i).Location; return v; })
+        .def("GetImpactPoint", [](FHitResults& self, int i) { FVector v = self.Get(i).ImpactPoint; return v; })
+        .def("GetNormal", [](FHitResults& self, int i) { FVector v = self.Get(i).Normal; return v; })
+        .def("GetDistance", [](FHitResults& self, int i) { return self.Get(i).Distance; })
+        .def("IsBlockingHit", [](FHitResults& self, int i) { return (bool)self.Get(i).bBlockingHit; })
+        .def_property_readonly("locations", [](FHitResults& self) { return _HitVectorsToBuffer(self.hits, [](const FHitResult& h) -> FVector { return h.Location; }); })
+        .def_property_readonly("impactPoints", [](FHitResults& self) { return _HitVectorsToBuffer(self.hits, [](const FHitResult& h) -> FVector { return h.ImpactPoint; }); })
+        .def_property_readonly("normals", [](FHitResults& self) { return _HitVectorsToBuffer(self.hits, [](const FHitResult& h) -> FVector { return h.Normal; }); })
+        .def_property_readonly("impactNormals", [](FHitResults& self) { return _HitVectorsToBuffer(self.hits, [](const FHitResult& h) -> FVector { return h.ImpactNormal; }); })
+        .def_property_readonly("distances", [](FHitResults& self)
+        {
+            TArray<float> values;
+            values.Reserve(self.hits.Num());
+            for (const FHitResult& h : self.hits)
+                values.Emplace(h.Distance);
+            return MakePyBuffer(values.GetData(), values.Num());
+        })
+        .def_property_readonly("blocking", [](FHitResults& self)
+        {
+            TArray<uint8> values;
+            values.Reserve(self.hits.Num());
+            for (const FHitResult& h : self.hits)
+                values.Emplace(h.bBlockingHit ? 1 : 0);
+            return MakePyBuffer(values.GetData(), values.Num());
+        })
+        .def_property_readonly("actors", [](FHitResults& self)
+        {   // one entry per hit (None if the actor is gone)
+            py::list ret;
+            for (const FHitResult& h : self.hits)
+            {
+                AActor* a = h.GetActor();
+                if (a)
+                    ret.append(a);
+                else
+                    ret.append(py::none());
+            }
+            return ret;
+        }, py::return_value_policy::reference)
+        .def_property_readonly("components", [](FHitResults& self)
+        {
+            py::list ret;
+            for (const FHitResult& h : self.hits)
+            {
+                UPrimitiveComponent* c = h.GetComponent();
+                if (c)
+                    ret.append(c);
+                else
+                    ret.append(py::none());
+            }
+            return ret;
+        }, py::return_value_policy::reference)
+        ;
+
+    py::class_<FTraceQuery>(m, "TraceQuery")
+        .def(py::init([](int channel, bool isComplex, py::object& ignore, py::object& objectTypes, int mobility)
+        {
+            FTraceQuery* q = new FTraceQuery();
+            q->channel = (ECollisionChannel)channel;
+            q->params.bTraceComplex = isComplex;
+            q->params.MobilityType = (EQueryMobilityType)mobility;
+            if (!ignore.is_none())
+                for (py::handle h : ignore)
+                    q->AddIgnoredActor(h.cast<AActor*>());
+            if (!objectTypes.is_none())
+            {
+                TArray<int32> types;
+                for (py::handle h : objectTypes)
+                    types.Emplace(h.cast<int>());
+                q->SetObjectTypes(types);
+            }
+            return q;
+        }), "channel"_a=(int)ECC_Visibility, "isComplex"_a=false, "ignore"_a=py::none(), "objectTypes"_a=py::none(), "mobility"_a=(int)EQueryMobilityType::Any)
+        .def_property("channel", [](FTraceQuery& self) { return (int)self.channel; }, [](FTraceQuery& self, int c) { self.channel = (ECollisionChannel)c; })
+        .def_property("isComplex", [](FTraceQuery& self) { return self.params.bTraceComplex; }, [](FTraceQuery& self, bool b) { self.params.bTraceComplex = b; })
+        .def_property("mobility", [](FTraceQuery& self) { return (int)self.params.MobilityType; }, [](FTraceQuery& self, int v) { self.params.MobilityType = (EQueryMobilityType)v; })
+        .def_property("returnPhysMaterial", [](FTraceQuery& self) { return self.params.bReturnPhysicalMaterial; }, [](FTraceQuery& self, bool b) { self.params.bReturnPhysicalMaterial = b; })
+        .def_property("objectTypes", [](FTraceQuery& self)
+        {
+            py::list ret;
+            for (int32 type : self.objectTypes)
+                ret.append(type);
+            return ret;
+        }, [](FTraceQuery& self, py::list& _types)
+        {
+            TArray<int32> types;
+            for (py::handle h : _types)
+                types.Emplace(h.cast<int>());
+            self.SetObjectTypes(types);
+        })
+        .def("AddIgnoredActor", [](FTraceQuery& self, AActor* a) { self.AddIgnoredActor(a); })
+        .def("AddIgnoredActors", [](FTraceQuery& self, py::list& actors) { for (py::handle h : actors) self.AddIgnoredActor(h.cast<AActor*>()); })
+        .def("RemoveIgnoredActor", [](FTraceQuery& self, AActor* a) { self.RemoveIgnoredActor(a); })
+        .def("ClearIgnoredActors", [](FTraceQuery& self) { self.ClearIgnoredActors(); })
+        .def("AddIgnoredComponent", [](FTraceQuery& self, UPrimitiveComponent* c) { self.AddIgnoredComponent(c); })
+        .def("RemoveIgnoredComponent", [](FTraceQuery& self, UPrimitiveComponent* c) { self.RemoveIgnoredComponent(c); })
+        .def("ClearIgnoredComponents", [](FTraceQuery& self) { self.ClearIgnoredComponents(); })
+        .def_property_readonly("ignoredActors", [](FTraceQuery& self)
+        {
+            py::list ret;
+            for (TWeakObjectPtr<AActor>& a : self.ignoredActors)
+                if (a.IsValid())
+                    ret.append(a.Get());
+            return ret;
+        }, py::return_value_policy::reference)
+        .def("LineTraceSingle", [](FTraceQuery& self, UWorld* world, FVector& start, FVector& end)
+        {
+            FHitResult hitResult;
+            bool hit = self.LineTraceSingle(world, hitResult, start, end);
+            return py::make_tuple(hitResult, hit);
+        }, py::return_value_policy::reference)
+        .def("LineTraceMulti", [](FTraceQuery& self, UWorld* world, FVector& start, FVector& end)
+        {
+            TArray<FHitResult> hits;
+            self.LineTraceMulti(world, hits, start, end);
+            return new FHitResults(MoveTemp(hits));
+        })
+        .def("SphereTraceMulti", [](FTraceQuery& self, UWorld* world, FVector& start, FVector& end, float radius)
+        {
+            TArray<FHitResult> hits;
+            self.SweepMulti(world, hits, start, end, FQuat::Identity, FCollisionShape::MakeSphere(radius));
+            return new FHitResults(MoveTemp(hits));
+        })
+        .def("SphereTraceSingle", [](FTraceQuery& self, UWorld* world, FVector& start, FVector& end, float radius)
+        {
+            FHitResult hitResult;
+            bool hit = self.SweepSingle(world, hitResult, start, end, FQuat::Identity, FCollisionShape::MakeSphere(radius));
+            return py::make_tuple(hitResult, hit);
+        }, py::return_value_policy::reference)
+        .def("BoxTraceSingle", [](FTraceQuery& self, UWorld* world, FVector& start, FVector& end, FVector& halfSize, FRotator& orientation)
+        {
+            FHitResult hitResult;
+            bool hit = self.SweepSingle(world, hitResult, start, end, orientation.Quaternion(), FCollisionShape::MakeBox(halfSize));
+            return py::make_tuple(hitResult, hit);
+        }, py::return_value_policy::reference)
+        .def("OverlapSphere", [](FTraceQuery& self, UWorld* world, FVector& center, float radius)
+        {   // returns a list of overlapping components
+            TArray<FOverlapResult> overlaps;
+            self.OverlapMulti(world, overlaps, center, FQuat::Identity, FCollisionShape::MakeSphere(radius));
+            py::list ret;
+            for (auto& o : overlaps)
+                if (o.Component.IsValid())
+                    ret.append(o.Component.Get());
+            return ret;
+        }, py::return_value_policy::reference)
+        .def("OverlapBox", [](FTraceQuery& self, UWorld* world, FVector& center, FVector& halfSize, FRotator& orientation)
+        {
+            TArray<FOverlapResult> overlaps;
+            self.OverlapMulti(world, overlaps, center, orientation.Quaternion(), FCollisionShape::MakeBox(halfSize));
+            py::list ret;
+            for (auto& o : overlaps)
+                if (o.Component.IsValid())
+                    ret.append(o.Component.Get());
+            return ret;
+        }, py::return_value_policy::reference)
+        ;
+
+    py::class_<FSpatialIndex, std::unique_ptr<FSpatialIndex, py::nodelete>>(m, "SpatialIndex")
+        .def("__len__", [](FSpatialIndex& self) { return self.Num(); })
+        .def("__repr__", [](FSpatialIndex& self) { return py::str("<SpatialIndex {} ({} actors)>").format(PYSTR(self.name.ToString()), self.Num()); })
+        .def_property_readonly("name", [](FSpatialIndex& self) { return PYSTR(self.name.ToString()); })
+        .def_property_readonly("cellSize", [](FSpatialIndex& self) { return self.GetCellSize(); })
+        .def("Add", [](FSpatialIndex& self, AActor* actor) { return self.Add(actor); })
+        .def("Remove", [](FSpatialIndex& self, AActor* actor) { self.Remove(actor); })
+        .def("Refresh", [](FSpatialIndex& self) { self.Refresh(); })
+        .def("Clear", [](FSpatialIndex& self) { self.Clear(); })
+        .def("GetID", [](FSpatialIndex& self, AActor* actor) { return self.GetID(actor); })
+        .def("GetActor", [](FSpatialIndex& self, int id) { return self.GetActor(id); }, py::return_value_policy::reference)
+        .def("GetActors", [](FSpatialIndex& self, py::object& _ids)
+        {   // converts a buffer of ids (e.g. from one of the batch queries) to a list of actors (None for any that are gone)
+            FPyBufferIn<int32> ids(_ids, 1, "ids");
+            py::list ret;
+            for (int32 i=0; i < ids.count; i++)
+            {
+                AActor* actor = self.GetActor(ids.data[i]);
+                if (actor)
+                    ret.append(py::cast(actor, py::return_value_policy::reference));
+                else
+                    ret.append(py::none());
+            }
+            return ret;
+        })
+        .def("QueryRadius", [](FSpatialIndex& self, FVector& center, float radius, bool asIDs)
+        {
+            TArray<int32> ids;
+            self.QueryRadius(center, radius, ids);
+            return _SpatialResults(self, ids, asIDs);
+        }, "center"_a, "radius"_a, "asIDs"_a=false)
+        .def("QueryKNearest", [](FSpatialIndex& self, FVector& center, int k, float maxRadius, bool asIDs)
+        {
+            TArray<int32> ids;
+            self.QueryKNearest(center, k, maxRadius, ids);
+            return _SpatialResults(self, ids, asIDs);
+        }, "center"_a, "k"_a, "maxRadius"_a=FLT_MAX, "asIDs"_a=false)
+        .def("QueryBox", [](FSpatialIndex& self, FBox& box, bool asIDs)
+        {
+            TArray<int32> ids;
+            self.QueryBox(box, ids);
+            return _SpatialResults(self, ids, asIDs);
+        }, "box"_a, "asIDs"_a=false)
+        .def("QueryFrustum", [](FSpatialIndex& self, py::list& _planes, float radius, bool asIDs)
+        {   // planes face outward, as in FConvexVolume
+            TArray<FPlane> planes;
+            for (py::handle h : _planes)
+                planes.Emplace(h.cast<FPlane>());
+            FConvexVolume frustum(planes);
+            TArray<int32> ids;
+            self.QueryFrustum(frustum, radius, ids);
+            return _SpatialResults(self, ids, asIDs);
+        }, "planes"_a, "radius"_a=0.0f, "asIDs"_a=false)
+        .def("QueryRadiusBatch", [](FSpatialIndex& self, py::object& _centers, float radius)
+        {   // centers is a float32 buffer of xyz triples; returns (offsets, ids) - see _ParallelQueries
+            FPyBufferIn<float> centers(_centers, 3, "centers");
+            return _ParallelQueries(centers.count, [&](int32 i, TArray<int32>& out) { self.QueryRadius(centers.GetVector(i), radius, out); });
+        })
+        .def("QueryKNearestBatch", [](FSpatialIndex& self, py::object& _centers, int k, float maxRadius)
+        {
+            FPyBufferIn<float> centers(_centers, 3, "centers");
+            return _ParallelQueries(centers.count, [&](int32 i, TArray<int32>& out) { self.QueryKNearest(centers.GetVector(i), k, maxRadius, out); });
+        }, "centers"_a, "k"_a, "maxRadius"_a=FLT_MAX)
+        ;
+
+    py::class_<FMaterialParamHandle>(m, "MaterialParamHandle")
+        .def(py::init([](std::string& name) { return new FMaterialParamHandle(FName(FSTR(name))); }))
+        .def_property_readonly("name", [](FMaterialParamHandle& self) { return PYSTR(self.name.ToString()); })
+        .def("__repr__", [](FMaterialParamHandle& self) { return py::str("<MaterialParamHandle {}>").format(PYSTR(self.name.ToString())); })
+        .def("SetScalar", [](FMaterialParamHandle& self, UMaterialInstanceDynamic* mid, float v) { if (VALID(mid)) self.SetScalar(mid, v); })
+        .def("SetVector", [](FMaterialParamHandle& self, UMaterialInstanceDynamic* mid, FLinearColor& v) { if (VALID(mid)) self.SetVector(mid, v); })
+        .def("Reset", [](FMaterialParamHandle& self) { self.Reset(); }) // forgets all cached indices, e.g. after discarding a bunch of MIDs
+        ;
+
+    // sets one scalar param on many MIDs. values is either a single float applied to all of them, or a float32 buffer with
+    // one value per MID. Invalid MIDs are skipped.
+    m.def("SetScalarParams", [](py::list& _mids, FMaterialParamHandle& handle, py::object& _values)
+    {
+        int32 numMIDs = (int32)_mids.size();
+        bool single = py::isinstance<py::float_>(_values) || py::isinstance<py::int_>(_values);
+        float singleValue = single ? _values.cast<float>() : 0.0f;
+        TUniquePtr<FPyBufferIn<float>> values;
+        if (!single)
+        {
+            values = MakeUnique<FPyBufferIn<float>>(_values, 1, "values");
+            if (values->count != numMIDs)
+                throw py::value_error("need one value per MID");
+        }
+
+        int32 i = 0;
+        for (py::handle h : _mids)
+        {
+            UMaterialInstanceDynamic* mid = h.cast<UMaterialInstanceDynamic*>();
+            if (VALID(mid))
+                handle.SetScalar(mid, single ? singleValue : values->data[i]);
+            i++;
+        }
+    }, "mids"_a, "handle"_a, "values"_a);
+
+    // same, but for vector params. values is either a single LinearColor or a float32 buffer with 4 (rgba) values per MID.
+    m.def("SetVectorParams", [](py::list& _mids, FMaterialParamHandle& handle, py::object& _values)
+    {
+        int32 numMIDs = (int32)_mids.size();
+        bool single = py::isinstance<FLinearColor>(_values);
+        FLinearColor singleValue = single ? _values.cast<FLinearColor>() : FLinearColor::Black;
+        TUniquePtr<FPyBufferIn<float>> values;
+        if (!single)
+        {
+            values = MakeUnique<FPyBufferIn<float>>(_values, 4, "values");
+            if (values->count != numMIDs)
+                throw py::value_error("need one value per MID");
+        }
+
+        int32 i = 0;
+        for (py::handle h : _mids)
+        {
+            UMaterialInstanceDynamic* mid = h.cast<UMaterialInstanceDynamic*>();
+            if (VALID(mid))
+            {
+                if (single)
+                    handle.SetVector(mid, singleValue);
+                else
+                {
+                    const float* p = (*values)[i];
+                    handle.SetVector(mid, FLinearColor(p[0], p[1], p[2], p[3]));
+                }
+            }
+            i++;
+        }
+    }, "mids"_a, "handle"_a, "values"_a);
+
+    // batched UMeshComponent.SetOverrideMaterial: puts all of the given mesh comps into material override mode using mat
+    // for every slot (or, if mat is None, takes them out of override mode)
+    m.def("SetOverrideMaterials", [](py::list& _comps, UMaterialInterface* mat)
+    {
+        for (py::handle h : _comps)
+        {
+            UMeshComponent* comp = h.cast<UMeshComponent*>();
+            if (VALID(comp))
+                SetOverrideMaterial(comp, mat);
+        }
+    }, "comps"_a, "mat"_a);
+
+    // Batched component state toggles. comps is a list of components, values is either a single value for all of them or
+    // a buffer with one entry per comp (uint8/bool for the flags, uint8 ECollisionEnabled values for collision). Comps
+    // that are already in the requested state are skipped entirely. Visibility and hidden-in-game changes go through the
+    // normal setters, since those call virtual change hooks that some component types override; the plain render flags
+    // (see SetRenderFlagsBatch) are written directly and each changed comp's render state is marked dirty just once.
+    m.def("SetVisibilityBatch", [](py::list& comps, py::object& values, bool propagateToChildren)
+    {
+        _ForEachComponentValue<USceneComponent, uint8>(comps, values, [propagateToChildren](USceneComponent* comp, uint8 v)
+        {
+            if (comp->GetVisibleFlag() != (v != 0) || propagateToChildren)
+                comp->SetVisibility(v != 0, propagateToChildren);
+        });
+    }, "comps"_a, "values"_a, "propagateToChildren"_a=false);
+    m.def("SetHiddenInGameBatch", [](py::list& comps, py::object& values, bool propagateToChildren)
+    {
+        _ForEachComponentValue<USceneComponent, uint8>(comps, values, [propagateToChildren](USceneComponent* comp, uint8 v)
+        {
+            if (comp->bHiddenInGame != (v != 0) || propagateToChildren)
+                comp->SetHiddenInGame(v != 0, propagateToChildren);
+        });
+    }, "comps"_a, "values"_a, "propagateToChildren"_a=false);
+    m.def("SetCollisionEnabledBatch", [](py::list& comps, py::object& values)
+    {
+        _ForEachComponentValue<UPrimitiveComponent, uint8>(comps, values, [](UPrimitiveComponent* comp, uint8 v)
+        {
+            if (comp->GetCollisionEnabled() != (ECollisionEnabled::Type)v)
+                comp->SetCollisionEnabled((ECollisionEnabled::Type)v);
+        });
+    }, "comps"_a, "values"_a);
+    m.def("SetCastShadowBatch", [](py::list& comps, py::object& values)
+    {
+        TSet<UPrimitiveComponent*> changed;
+        _ForEachComponentValue<UPrimitiveComponent, uint8>(comps, values, [&changed](UPrimitiveComponent* comp, uint8 v)
+        {
+            if (comp->CastShadow != (v != 0))
+            {
+                comp->CastShadow = v != 0;
+                changed.Add(comp);
+            }
+        });
+        for (UPrimitiveComponent* comp : changed)
+            comp->MarkRenderStateDirty();
+    }, "comps"_a, "values"_a);
+
+    // Sets several render-only flags on lots of primitive comps at once. Each arg is None (leave it alone), a single value
+    // for all comps, or a buffer with one entry per comp. The flags are written directly (these are the fields whose engine
+    // setters just set the field and mark the render state dirty), and then each comp that had anything change gets one
+    // MarkRenderStateDirty, instead of one per changed field.
+    m.def("SetRenderFlagsBatch", [](py::list& comps, py::object& castShadow, py::object& renderCustomDepth, py::object& customDepthStencil, py::object& receivesDecals)
+    {
+        TSet<UPrimitiveComponent*> changed;
+        if (!castShadow.is_none())
+            _ForEachComponentValue<UPrimitiveComponent, uint8>(comps, castShadow, [&changed](UPrimitiveComponent* comp, uint8 v)
+            {
+                if (comp->CastShadow != (v != 0))
+                {
+                    comp->CastShadow = v != 0;
+                    changed.Add(comp);
+                }
+            });
+        if (!renderCustomDepth.is_none())
+            _ForEachComponentValue<UPrimitiveComponent, uint8>(comps, renderCustomDepth, [&changed](UPrimitiveComponent* comp, uint8 v)
+            {
+                if (comp->bRenderCustomDepth != (v != 0))
+                {
+                    comp->bRenderCustomDepth = v != 0;
+                    changed.Add(comp);
+                }
+            });
+        if (!customDepthStencil.is_none())
+            _ForEachComponentValue<UPrimitiveComponent, uint8>(comps, customDepthStencil, [&changed](UPrimitiveComponent* comp, uint8 v)
+            {
+                if (comp->CustomDepthStencilValue != (int32)v)
+                {
+                    comp->CustomDepthStencilValue = v;
+                    changed.Add(comp);
+                }
+            });
+        if (!receivesDecals.is_none())
+            _ForEachComponentValue<UPrimitiveComponent, uint8>(comps, receivesDecals, [&changed](UPrimitiveComponent* comp, uint8 v)
+            {
+                if (comp->bReceivesDecals != (v != 0))
+                {
+                    comp->bReceivesDecals = v != 0;
+                    changed.Add(comp);
+                }
+            });
+        for (UPrimitiveComponent* comp : changed)
+            comp->MarkRenderStateDirty();
+    }, "comps"_a, "castShadow"_a=py::none(), "renderCustomDepth"_a=py::none(), "customDepthStencil"_a=py::none(), "receivesDecals"_a=py::none());
+
+    py::class_<FNiagaraParamHandle>(m, "NiagaraParamHandle")
+        .def(py::init([](std::string& name) { return new FNiagaraParamHandle(FName(FSTR(name))); }))
+        .def_property_readonly("name", [](FNiagaraParamHandle& self) { return PYSTR(self.name.ToString()); })
+        .def("__repr__", [](FNiagaraParamHandle& self) { return py::str("<NiagaraParamHandle {}>").format(PYSTR(self.name.ToString())); })
+        .def("SetBool", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, bool v) { comp->SetVariableBool(self.name, v); })
+        .def("SetInt", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, int v)
+        {
+            _SetNiagaraParam(self, comp, FNiagaraTypeDefinition::GetIntDef(), (int32)v, [](UNiagaraComponent* c, FName n, int32 v) { c->SetVariableInt(n, v); });
+        })
+        .def("SetFloat", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, float v)
+        {
+            _SetNiagaraParam(self, comp, FNiagaraTypeDefinition::GetFloatDef(), v, [](UNiagaraComponent* c, FName n, float v) { c->SetVariableFloat(n, v); });
+        })
+        .def("SetVec2", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, FVector2D& v)
+        {
+            _SetNiagaraParam(self, comp, FNiagaraTypeDefinition::GetVec2Def(), v, [](UNiagaraComponent* c, FName n, const FVector2D& v) { c->SetVariableVec2(n, v); });
+        })
+        .def("SetVec3", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, FVector& v)
+        {
+            _SetNiagaraParam(self, comp, FNiagaraTypeDefinition::GetVec3Def(), v, [](UNiagaraComponent* c, FName n, const FVector& v) { c->SetVariableVec3(n, v); });
+        })
+        .def("SetColor", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, FLinearColor& v)
+        {
+            _SetNiagaraParam(self, comp, FNiagaraTypeDefinition::GetColorDef(), v, [](UNiagaraComponent* c, FName n, const FLinearColor& v) { c->SetVariableLinearColor(n, v); });
+        })
+        .def("SetObject", [](FNiagaraParamHandle& self, UNiagaraComponent* comp, UObject* v) { comp->SetVariableObject(self.name, v); })
+        .def("SetFloats", [](FNiagaraParamHandle& self, py::list& _comps, py::object& _values)
+        {   // sets this param on each of many components, one value per component
+            FPyBufferIn<float> values(_values, 1, "values");
+            if (values.count != (int32)_comps.size())
+                throw py::value_error("need one value per component");
+            int32 i = 0;
+            for (py::handle h : _comps)
+            {
+                _SetNiagaraParam(self, h.cast<UNiagaraComponent*>(), FNiagaraTypeDefinition::GetFloatDef(), values.data[i], [](UNiagaraComponent* c, FName n, float v) { c->SetVariableFloat(n, v); });
+                i++;
+            }
+        })
+        .def("SetVec3s", [](FNiagaraParamHandle& self, py::list& _comps, py::object& _values)
+        {
+            FPyBufferIn<float> values(_values, 3, "values");
+            if (values.count != (int32)_comps.size())
+                throw py::value_error("need one value per component");
+            int32 i = 0;
+            for (py::handle h : _comps)
+            {
+                _SetNiagaraParam(self, h.cast<UNiagaraComponent*>(), FNiagaraTypeDefinition::GetVec3Def(), values.GetVector(i), [](UNiagaraComponent* c, FName n, const FVector& v) { c->SetVariableVec3(n, v); });
+                i++;
+            }
+        })
+        .def("Reset", [](FNiagaraParamHandle& self) { self.Reset(); }) // forgets all cached param locations
+        .def("SetArrayFloat", [](py::object& self, UNiagaraComponent* comp, py::object& values) { SetNiagaraArrayFloat(comp, self, values); })
+        .def("SetArrayVector", [](py::object& self, UNiagaraComponent* comp, py::object& values) { SetNiagaraArrayVector(comp, self, values); })
+        .def("SetArrayColor", [](py::object& self, UNiagaraComponent* comp, py::object& values) { SetNiagaraArrayColor(comp, self, values); })
+        .def("SetArrayInt32", [](py::object& self, UNiagaraComponent* comp, py::object& values) { SetNiagaraArrayInt32(comp, self, values); })
+        ;
+
+    // gets (creating if needed) a named spatial index
+    m.def("GetSpatialIndex", [](std::string& name, float cellSize) { return FSpatialIndex::Get(FName(FSTR(name)), cellSize); }, "name"_a, "cellSize"_a=1000.0f, py::return_value_policy::reference);
+    m.def("GetAllSpatialIndices", []()
+    {
+        py::list ret;
+        for (FSpatialIndex* index : FSpatialIndex::GetAll())
+            ret.append(py::cast(index, py::return_value_policy::reference));
+        return ret;
+    });
+
+    // tick rate LOD for Python actors - see TickLOD.h
+    py::class_<FTickLODManager, std::unique_ptr<FTickLODManager, py::nodelete>>(m, "TickLODManager")
+        .def("__len__", [](FTickLODManager& self) { return self.Num(); })
+        .def("Register", [](FTickLODManager& self, AActor* actor) { self.Register(actor); })
+        .def("Unregister", [](FTickLODManager& self, AActor* actor) { self.Unregister(actor); })
+        .def("SetBuckets", [](FTickLODManager& self, py::list& thresholds, py::list& intervals)
+        {   // e.g. SetBuckets([2000, 10000], [0, 0.2, 1.0]) = full rate under 20m, 5Hz under 100m, 1Hz beyond that
+            TArray<float> t, i;
+            for (auto v : thresholds)
+                t.Emplace(v.cast<float>());
+            for (auto v : intervals)
+                i.Emplace(v.cast<float>());
+            if (!self.SetBuckets(t, i))
+                throw py::value_error("there must be exactly one more interval than thresholds");
+        }, "thresholds"_a, "intervals"_a)
+        .def("SetScorer", [](FTickLODManager& self, py::object& scorer) { self.SetScorer(scorer); })
+        .def("Update", [](FTickLODManager& self) { self.Update(); })
+        .def("GetBucket", [](FTickLODManager& self, AActor* actor) { return self.GetBucket(actor); })
+        .def_readwrite("maxPerUpdate", &FTickLODManager::maxPerUpdate)
+        .def_property("updateInterval", [](FTickLODManager& self) { return self.updateInterval; }, [](FTickLODManager& self, float v) { self.SetUpdateInterval(v); })
+        ;
+    m.def("GetTickLODManager", []() { return &FTickLODManager::Get(); }, py::return_value_policy::reference);
+
+    // Does one single-hit line trace for each (start, end) pair. starts and ends are flat float32 buffers of xyz triples.
+    // The GIL is released while the traces run. If params is a TraceQuery, the channel arg is used instead of the
+    // query's channel.
+    m.def("LineTraceBatch", [](UWorld* world, py::object& _starts, py::object& _ends, int channel, py::object& params)
+    {
+        FPyBufferIn<float> starts(_starts, 3, "starts");
+        FPyBufferIn<float> ends(_ends, 3, "ends");
+        if (starts.count != ends.count)
+            throw py::value_error("starts and ends must have the same number of points");
+        if (!VALID(world))
+            throw py::value_error("invalid world");
+
+        FTraceQuery scratch;
+        FTraceQuery* query = _TraceQueryFromPy(params, scratch);
+        query->GetParams(); // make sure any rebuilding happens while we still hold the GIL
+        FTraceBatchResults* results = new FTraceBatchResults();
+        results->Reset(starts.count);
+        {
+            py::gil_scoped_release release;
+            FHitResult hitResult;
+            for (int32 i=0; i < starts.count; i++)
+            {
+                if (query->LineTraceSingle(world, hitResult, starts.GetVector(i), ends.GetVector(i), channel))
+                    results->Set(i, hitResult);
+            }
+        }
+        return results;
+    }, py::arg("world"), py::arg("starts"), py::arg("ends"), py::arg("channel"), py::arg("params")=py::none());
+
+    // Same as LineTraceBatch, but uses the engine's async trace API so the work overlaps with the rest of the frame. All
+    // results are delivered in a single call to callback(results) on the game thread in the next frame. If the world is
+    // cleaned up first, callback(None) is called instead.
+    m.def("AsyncLineTraceBatch", [](UWorld* world, py::object& _starts, py::object& _ends, int channel, py::object& callback, py::object& params)
+    {
+        FPyBufferIn<float> starts(_starts, 3, "starts");
+        FPyBufferIn<float> ends(_ends, 3, "ends");
+        if (starts.count != ends.count)
+            throw py::value_error("starts and ends must have the same number of points");
+        if (!VALID(world))
+            throw py::value_error("invalid world");
+
+        FTraceQuery scratch;
+        FTraceQuery* query = _TraceQueryFromPy(params, scratch);
+        TSharedPtr<FAsyncTraceBatch> batch = MakeShared<FAsyncTraceBatch>();
+        batch->results.Reset(starts.count);
+        batch->remaining = starts.count;
+        batch->callback = callback;
+        batch->world = world;
+
+        if (starts.count == 0)
+        {   // nothing to do, but still honor the "called next frame" contract
+            AsyncTask(ENamedThreads::GameThread, [batch]() { batch->Deliver(false); });
+            return;
+        }
+
+        // the engine drops pending traces when the world goes away, so anyone waiting on this batch would wait forever
+        TWeakPtr<FAsyncTraceBatch> weakBatch = batch;
+        batch->cleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([weakBatch](UWorld* w, bool sessionEnded, bool cleanupResources)
+        {
+            TSharedPtr<FAsyncTraceBatch> b = weakBatch.Pin();
+            if (b && (!b->world.IsValid() || b->world.Get() == w))
+                b->Deliver(true);
+        });
+
+        // the engine stores a copy of the delegate with each trace, and each copy holds a strong ref to the batch, so it stays
+        // alive until all traces have reported in or the engine throws the traces away with the world
+        FTraceDelegate delegate = FTraceDelegate::CreateLambda([batch](const FTraceHandle& handle, FTraceDatum& datum)
+        {
+            int32 i = (int32)datum.UserData;
+            for (const FHitResult& h : datum.OutHits)
+            {
+                if (h.bBlockingHit)
+                {
+                    batch->results.Set(i, h);
+                    break;
+                }
+            }
+            if (--batch->remaining == 0)
+                batch->Deliver(false);
+        });
+
+        const FCollisionQueryParams& queryParams = query->GetParams();
+        for (int32 i=0; i < starts.count; i++)
+        {
+            if (query->UsesObjectTypes())
+                world->AsyncLineTraceByObjectType(EAsyncTraceType::Single, starts.GetVector(i), ends.GetVector(i), query->objectParams, queryParams, &delegate, (uint32)i);
+            else
+                world->AsyncLineTraceByChannel(EAsyncTraceType::Single, starts.GetVector(i), ends.GetVector(i), (ECollisionChannel)channel, queryParams, FCollisionResponseParams::DefaultResponseParam, &delegate, (uint32)i);
+        }
+    }, py::arg("world"), py::arg("starts"), py::arg("ends"), py::arg("channel"), py::arg("callback"), py::arg("params")=py::none());
+}
+
+//#pragma optimize("", on)
+
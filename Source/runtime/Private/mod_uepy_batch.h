@@ -0,0 +1,209 @@
+// batched APIs for the uepy builtin module - stuff that needs to do a lot of work with as few Python<-->C++ crossings
+// as possible. See uepy_kernels.h for the buffer helpers.
+
+#pragma once
+#include "uepy.h"
+#include "uepy_kernels.h"
+#include "UObject/ObjectKey.h"
+
+// SoA results of a batch of single-hit traces. Actors that were hit are stored once each, and actorIndex refers
+// into that list (or is -1 for no hit).
+struct FTraceBatchResults
+{
+    TArray<uint8> hit;
+    TArray<float> distance;
+    TArray<FVector> location;
+    TArray<FVector> normal;
+    TArray<int32> actorIndex;
+    TArray<TWeakObjectPtr<AActor>> actors;
+    TMap<AActor*, int32> actorToIndex;
+
+    void Reset(int32 count);
+    void Set(int32 i, const FHitResult& hitResult);
+    int32 NumHits() const;
+};
+
+// CSR-style results of a batch of multi-result queries (overlaps, multi-hit sweeps): the results for query i are entries
+// offsets[i] through offsets[i+1]-1. Each entry refers to an actor and a component by index into the actors/components
+// lists, so each object shows up only once no matter how many queries found it.
+struct FQueryBatchResults
+{
+    TArray<int32> offsets;
+    TArray<int32> actorIndex; // per entry, -1 if none
+    TArray<int32> componentIndex; // per entry, -1 if none
+    TArray<float> distance; // per entry, sweeps only
+    TArray<FVector> location; // per entry, sweeps only
+    TArray<TWeakObjectPtr<AActor>> actors;
+    TArray<TWeakObjectPtr<UPrimitiveComponent>> components;
+    TMap<AActor*, int32> actorToIndex;
+    TMap<UPrimitiveComponent*, int32> componentToIndex;
+
+    void BeginQuery() { offsets.Emplace(actorIndex.Num()); }
+    void EndBatch() { offsets.Emplace(actorIndex.Num()); }
+    void AddEntry(AActor* actor, UPrimitiveComponent* comp);
+    int32 NumQueries() const { return FMath::Max(offsets.Num()-1, 0); }
+};
+
+// batch overlap/sweep queries, exposed as UWorld methods. shapes/extents/rotations can be a single value applied to every
+// query or one per query, and params is anything _TraceQueryFromPy accepts.
+FQueryBatchResults* OverlapSphereBatch(UWorld* world, py::object& centers, py::object& radii, int channel, py::object& params);
+FQueryBatchResults* OverlapBoxBatch(UWorld* world, py::object& centers, py::object& extents, py::object& rotations, int channel, py::object& params);
+FQueryBatchResults* SweepBatch(UWorld* world, py::object& starts, py::object& ends, py::object& radii, int channel, py::object& params);
+
+// Compact container for the results of a multi-hit query. It acts like a read-only sequence of FHitResult, but
+// individual FHitResult wrappers are only created when an element is actually accessed, and the commonly used fields
+// can be pulled out all at once as buffers.
+struct FHitResults
+{
+    TArray<FHitResult> hits;
+
+    FHitResults() {}
+    FHitResults(TArray<FHitResult>&& _hits) : hits(MoveTemp(_hits)) {}
+    const FHitResult& Get(int32 i) const; // supports negative indices, throws IndexError
+};
+
+// Reusable query settings that Python builds once and then passes to any of the trace or overlap APIs, so that ignore
+// lists and the like don't have to be rebuilt from Python lists on every call. If any object types have been set, queries
+// are done by object type, otherwise they are done against the trace channel.
+struct FTraceQuery
+{
+    FCollisionQueryParams params;
+    FCollisionObjectQueryParams objectParams;
+    ECollisionChannel channel = ECC_Visibility;
+    TArray<int32> objectTypes; // ECollisionChannel values
+    TArray<TWeakObjectPtr<AActor>> ignoredActors;
+    TArray<TWeakObjectPtr<UPrimitiveComponent>> ignoredComponents;
+    bool ignoresDirty = false; // true when something was removed from the ignore lists and params has to be rebuilt
+
+    FTraceQuery();
+    bool UsesObjectTypes() const { return objectTypes.Num() > 0; }
+    void SetObjectTypes(const TArray<int32>& types);
+    void AddIgnoredActor(AActor* actor);
+    void RemoveIgnoredActor(AActor* actor);
+    void ClearIgnoredActors();
+    void AddIgnoredComponent(UPrimitiveComponent* comp);
+    void RemoveIgnoredComponent(UPrimitiveComponent* comp);
+    void ClearIgnoredComponents();
+    const FCollisionQueryParams& GetParams(); // rebuilds params first if needed
+
+    // query wrappers. channelOverride >= 0 means to use that channel instead of this query's channel (ignored if
+    // querying by object types)
+    bool LineTraceSingle(UWorld* world, FHitResult& outHit, const FVector& start, const FVector& end, int channelOverride=-1);
+    bool LineTraceMulti(UWorld* world, TArray<FHitResult>& outHits, const FVector& start, const FVector& end, int channelOverride=-1);
+    bool SweepSingle(UWorld* world, FHitResult& outHit, const FVector& start, const FVector& end, const FQuat& rot, const FCollisionShape& shape, int channelOverride=-1);
+    bool SweepMulti(UWorld* world, TArray<FHitResult>& outHits, const FVector& start, const FVector& end, const FQuat& rot, const FCollisionShape& shape, int channelOverride=-1);
+    bool OverlapMulti(UWorld* world, TArray<FOverlapResult>& outOverlaps, const FVector& pos, const FQuat& rot, const FCollisionShape& shape, int channelOverride=-1);
+};
+
+// Converts the 'params' arg of the trace/overlap APIs into a query. Params can be a TraceQuery (returned as-is), None, or a
+// list of actors to ignore (in both of those cases, scratch is filled in and returned).
+FTraceQuery* _TraceQueryFromPy(const py::object& params, FTraceQuery& scratch);
+
+// Curve evaluation in bulk. Each channel is evaluated from its FRichCurve; for color curves, the asset's hue/saturation/
+// brightness/etc. adjustments are then applied the same way UCurveLinearColor::GetLinearColorValue does. The adjustment
+// settings are copied out of the asset in Init so that Eval never touches the UObject.
+struct FCurveChannels
+{
+    struct FColorAdjustments
+    {
+        float hue = 0.0f;
+        float saturation = 1.0f;
+        float brightness = 1.0f;
+        float brightnessCurve = 1.0f;
+        float vibrance = 0.0f;
+        float minAlpha = 0.0f;
+        float maxAlpha = 1.0f;
+    };
+
+    TArray<const FRichCurve*> channels;
+    bool isColor = false; // if true, colorAdjustments get applied
+    FColorAdjustments colorAdjustments;
+
+    bool Init(UCurveBase* curve); // false if the curve is invalid or unsupported; call on the game thread
+    int32 Num() const { return channels.Num(); }
+    void Eval(float time, float* out) const; // writes Num() values to out; safe to call from worker threads
+};
+py::object EvaluateCurveBatch(UCurveBase* curve, py::object& times); // returns a (numTimes, numChannels) buffer
+
+// A curve pre-sampled at uniform intervals, so evaluating it is a lerp between two table entries no matter how many keys
+// the original curve had. Times outside of the baked range are clamped.
+struct FCurveLUT
+{
+    float minTime = 0.0f;
+    float maxTime = 0.0f;
+    int32 numSamples = 0;
+    int32 numChannels = 0;
+    TArray<float> values; // numSamples rows of numChannels values
+
+    void Bake(UCurveBase* curve, int32 samples, float start, float end);
+    void Eval(float time, float* out) const; // writes numChannels values to out
+};
+
+// Niagara user parameter handle - resolves a parameter name to an FName once, so that sets done every frame skip the
+// std::string-->FString-->FName conversion (and FName hash lookup) that the name-based APIs do on every call. For
+// numeric params it also remembers, per component, where the param lives in the component's override parameter store,
+// so a set is just a copy into the store instead of a search of the store by name. A cached location is checked against
+// the store before use, so it's harmless if the store gets rebuilt (e.g. the component's system asset changes).
+class UNiagaraComponent;
+struct FNiagaraTypeDefinition;
+struct FNiagaraParamHandle
+{
+    struct FLocation
+    {
+        FName storeName; // the name as it appears in the store, e.g. with a User. prefix
+        int32 index = INDEX_NONE; // into the store's parameter list
+        int32 offset = INDEX_NONE; // into the store's parameter data
+    };
+
+    FName name;
+    TMap<FObjectKey, FLocation> locations; // per component
+    int32 pruneAt = 64; // see _PruneDeadKeys
+
+    FNiagaraParamHandle(FName _name) : name(_name) {}
+    int32 FindOffset(UNiagaraComponent* comp, const FNiagaraTypeDefinition& type); // INDEX_NONE if the comp doesn't have it
+    void Reset() { locations.Empty(); }
+};
+FName _NiagaraNameFromPy(const py::object& nameOrHandle); // accepts a str or a NiagaraParamHandle
+
+// bulk setters for Niagara array data interfaces, fed from Python buffers (float32 values, float32 xyz triples, float32
+// rgba quads, and int32 values, respectively)
+void SetNiagaraArrayFloat(UNiagaraComponent* comp, py::object& name, py::object& values);
+void SetNiagaraArrayVector(UNiagaraComponent* comp, py::object& name, py::object& values);
+void SetNiagaraArrayColor(UNiagaraComponent* comp, py::object& name, py::object& values);
+void SetNiagaraArrayInt32(UNiagaraComponent* comp, py::object& name, py::object& values);
+
+// Material parameter handle for updating the same parameter on lots of MIDs. The name is converted to an FName once, and
+// for each MID we remember the parameter's index in its parameter array, so later sets go straight to that entry instead
+// of searching by name. Cached indices are verified before use, so it's harmless if a MID's params get cleared/rebuilt.
+struct FMaterialParamHandle
+{
+    FName name;
+    TMap<FObjectKey, int32> scalarIndices;
+    TMap<FObjectKey, int32> vectorIndices;
+    int32 scalarPruneAt = 64, vectorPruneAt = 64; // see _PruneDeadKeys
+
+    FMaterialParamHandle(FName _name) : name(_name) {}
+    void SetScalar(UMaterialInstanceDynamic* mid, float value);
+    void SetVector(UMaterialInstanceDynamic* mid, const FLinearColor& value);
+    void Reset() { scalarIndices.Empty(); vectorIndices.Empty(); }
+};
+
+// for the per-object caches above: when a new entry is about to be added and the map has reached pruneAt entries, drops
+// the entries for objects that have gone away, so the caches don't grow forever as objects come and go
+template<typename V>
+void _PruneDeadKeys(TMap<FObjectKey, V>& map, int32& pruneAt)
+{
+    if (map.Num() < pruneAt)
+        return;
+    for (auto it = map.CreateIterator(); it; ++it)
+        if (!it->Key.ResolveObjectPtr())
+            it.RemoveCurrent();
+    pruneAt = FMath::Max(64, map.Num() * 2);
+}
+
+// enters/exits material override mode on a mesh comp (newMat=nullptr to exit) - see UMeshComponent.SetOverrideMaterial
+void SetOverrideMaterial(UMeshComponent* comp, UMaterialInterface* newMat);
+
+void _LoadModuleBatch(py::module& uepy);
+void _LoadModuleKernels(py::module& uepy);
+
@@ -0,0 +1,406 @@
+// builtin batch kernels (the uepy.kernels module) - see uepy_kernels.h
+
+#include "mod_uepy_batch.h"
+#include "common.h"
+#include "Async/ParallelFor.h"
+#include "Curves/CurveFloat.h"
+#include "Curves/CurveLinearColor.h"
+#include "Curves/CurveVector.h"
+
+using namespace pybind11::literals;
+
+//#pragma optimize("", off)
+
+static py::module* kernelsModule = nullptr; // intentionally never freed, so it isn't released after the interpreter is gone
+
+py::module& FUEPyKernels::Module()
+{
+    check(kernelsModule);
+    return *kernelsModule;
+}
+
+void FUEPyKernels::ParallelFor(int32 count, TFunctionRef<void(int32)> body)
+{
+    py::gil_scoped_release release;
+    ::ParallelFor(count, body);
+}
+
+// the memory behind buffers from MakePyBuffer, which Python only sees through memoryviews. (A memoryview.cast of a
+// bytearray would be simpler, but cast refuses shapes with a 0 in them, and empty results are common - no hits, etc.)
+struct FPyBufferData
+{
+    TArray<uint8> bytes;
+    int32 itemSize = 0;
+    std::string format;
+    std::vector<py::ssize_t> shape;
+};
+
+py::object _MakePyBuffer(const void* data, int32 itemSize, const std::string& format, int32 count, int32 cols)
+{
+    FPyBufferData* buf = new FPyBufferData();
+    buf->itemSize = itemSize;
+    buf->format = format;
+    count = FMath::Max(count, 0);
+    buf->shape.push_back(count);
+    int64 numBytes = (int64)count * itemSize;
+    if (cols >= 0)
+    {
+        buf->shape.push_back(cols);
+        numBytes *= cols;
+    }
+    buf->bytes.SetNumUninitialized(FMath::Max<int64>(numBytes, 1)); // at least 1 byte so the buffer pointer is never null
+    if (numBytes > 0)
+        FMemory::Memcpy(buf->bytes.GetData(), data, numBytes);
+    return py::memoryview(py::cast(buf, py::return_value_policy::take_ownership));
+}
+
+bool FCurveChannels::Init(UCurveBase* curve)
+{
+    channels.Reset();
+    isColor = false;
+    if (!VALID(curve))
+        return false;
+    if (UCurveFloat* f = Cast<UCurveFloat>(curve))
+        channels.Emplace(&f->FloatCurve);
+    else if (UCurveVector* v = Cast<UCurveVector>(curve))
+    {
+        for (int i=0; i < 3; i++)
+            channels.Emplace(&v->FloatCurves[i]);
+    }
+    else if (UCurveLinearColor* c = Cast<UCurveLinearColor>(curve))
+    {
+        for (int i=0; i < 4; i++)
+            channels.Emplace(&c->FloatCurves[i]);
+        isColor = true;
+        colorAdjustments.hue = c->AdjustHue;
+        colorAdjustments.saturation = c->AdjustSaturation;
+        colorAdjustments.brightness = c->AdjustBrightness;
+        colorAdjustments.brightnessCurve = c->AdjustBrightnessCurve;
+        colorAdjustments.vibrance = c->AdjustVibrance;
+        colorAdjustments.minAlpha = c->AdjustMinAlpha;
+        colorAdjustments.maxAlpha = c->AdjustMaxAlpha;
+    }
+    return channels.Num() > 0;
+}
+
+// same math as UCurveLinearColor::GetLinearColorValue, but on plain data
+static FLinearColor _AdjustCurveColor(const FLinearColor& original, const FCurveChannels::FColorAdjustments& adj)
+{
+    FLinearColor hsv = original.LinearRGBToHSV();
+    float hue = hsv.R;
+    float saturation = hsv.G;
+    float value = hsv.B;
+
+    value *= adj.brightness;
+    if (!FMath::IsNearlyEqual(adj.brightnessCurve, 1.0f, (float)KINDA_SMALL_NUMBER) && adj.brightnessCurve != 0.0f)
+        value = FMath::Pow(value, adj.brightnessCurve);
+
+    if (!FMath::IsNearlyZero(adj.vibrance, (float)KINDA_SMALL_NUMBER))
+    {   // "vibrancy": raises the saturation of less saturated colors more
+        float invSatRaised = FMath::Pow(1.0f - saturation, 5.0f);
+        float halfVibrance = FMath::Clamp(adj.vibrance, 0.0f, 1.0f) * 0.5f;
+        saturation += halfVibrance * invSatRaised;
+    }
+
+    saturation *= adj.saturation;
+    hue += adj.hue;
+
+    hue = FMath::Fmod(hue, 360.0f);
+    if (hue < 0.0f)
+        hue += 360.0f; // HSVToLinearRGB wants it positive
+    saturation = FMath::Clamp(saturation, 0.0f, 1.0f);
+    if (original.R <= 1.0f && original.G <= 1.0f && original.B <= 1.0f)
+        value = FMath::Clamp(value, 0.0f, 1.0f); // only clamp brightness for non-HDR colors
+
+    hsv.R = hue;
+    hsv.G = saturation;
+    hsv.B = value;
+    FLinearColor ret = hsv.HSVToLinearRGB();
+    ret.A = FMath::Lerp(adj.minAlpha, adj.maxAlpha, original.A);
+    return ret;
+}
+
+void FCurveChannels::Eval(float time, float* out) const
+{
+    for (int32 c=0; c < channels.Num(); c++)
+        out[c] = channels[c]->Eval(time);
+    if (isColor)
+    {
+        if (channels[3]->GetNumKeys() == 0)
+            out[3] = 1.0f; // same as the engine: no alpha keys means opaque
+        FLinearColor c = _AdjustCurveColor(FLinearColor(out[0], out[1], out[2], out[3]), colorAdjustments);
+        out[0] = c.R; out[1] = c.G; out[2] = c.B; out[3] = c.A;
+    }
+}
+
+py::object EvaluateCurveBatch(UCurveBase* curve, py::object& _times)
+{
+    FCurveChannels channels;
+    if (!channels.Init(curve))
+        throw py::value_error("invalid or unsupported curve");
+    FPyBufferIn<float> times(_times, 1, "times");
+    int32 numChannels = channels.Num();
+    TArray<float> out;
+    out.SetNumUninitialized(times.count * numChannels);
+    FUEPyKernels::ParallelFor(times.count, [&](int32 i) { channels.Eval(times.data[i], out.GetData() + i*numChannels); });
+    return MakePyBuffer(out.GetData(), times.count, numChannels);
+}
+
+void FCurveLUT::Bake(UCurveBase* curve, int32 samples, float start, float end)
+{
+    FCurveChannels channels;
+    if (!channels.Init(curve))
+        throw py::value_error("invalid or unsupported curve");
+    if (samples < 2)
+        throw py::value_error("need at least 2 samples");
+    minTime = start;
+    maxTime = FMath::Max(end, start + SMALL_NUMBER);
+    numSamples = samples;
+    numChannels = channels.Num();
+    values.SetNumUninitialized(numSamples * numChannels);
+    for (int32 i=0; i < numSamples; i++)
+    {
+        float t = FMath::Lerp(minTime, maxTime, (float)i / (numSamples-1));
+        channels.Eval(t, values.GetData() + i*numChannels);
+    }
+}
+
+void FCurveLUT::Eval(float time, float* out) const
+{
+    float pos = FMath::Clamp((time - minTime) / (maxTime - minTime), 0.0f, 1.0f) * (numSamples-1);
+    int32 i = FMath::Min((int32)pos, numSamples-2);
+    float alpha = pos - i;
+    const float* a = values.GetData() + i*numChannels;
+    const float* b = a + numChannels;
+    for (int32 c=0; c < numChannels; c++)
+        out[c] = FMath::Lerp(a[c], b[c], alpha);
+}
+
+// called on pre engine init
+void _LoadModuleKernels(py::module& uepy)
+{
+    LOG("Creating Python module uepy.kernels");
+
+    kernelsModule = new py::module(uepy.def_submodule("kernels"));
+    py::module& m = *kernelsModule;
+
+    py::class_<FPyBufferData>(m, "_BufferData", py::buffer_protocol())
+        .def_buffer([](FPyBufferData& self)
+        {
+            std::vector<py::ssize_t> strides(self.shape.size());
+            py::ssize_t stride = self.itemSize;
+            for (int i=(int)self.shape.size()-1; i >= 0; i--)
+            {
+                strides[i] = stride;
+                stride *= FMath::Max<py::ssize_t>(self.shape[i], 1);
+            }
+            return py::buffer_info(self.bytes.GetData(), self.itemSize, self.format, (py::ssize_t)self.shape.size(), self.shape, strides);
+        });
+
+    // a is an (N,3) float32 buffer, b is (M,3). Returns an (N,M) buffer of distances between every a and every b.
+    m.def("DistanceMatrix", [](py::object& _a, py::object& _b, bool squared)
+    {
+        FPyBufferIn<float> a(_a, 3, "a");
+        FPyBufferIn<float> b(_b, 3, "b");
+        TArray<float> out;
+        out.SetNumUninitialized(a.count * b.count);
+        FUEPyKernels::ParallelFor(a.count, [&](int32 i)
+        {
+            FVector p = a.GetVector(i);
+            float* row = out.GetData() + i * b.count;
+            for (int32 j=0; j < b.count; j++)
+            {
+                float d = FVector::DistSquared(p, b.GetVector(j));
+                row[j] = squared ? d : FMath::Sqrt(d);
+            }
+        });
+        return MakePyBuffer(out.GetData(), a.count, b.count);
+    }, "a"_a, "b"_a, "squared"_a=false);
+
+    // For each query point, finds the k closest points. Returns (indices, distances) buffers, each (Q,k); if there are
+    // fewer than k points, the extra slots have an index of -1 and a distance of -1.
+    m.def("KNearest", [](py::object& _points, py::object& _queries, int k)
+    {
+        FPyBufferIn<float> points(_points, 3, "points");
+        FPyBufferIn<float> queries(_queries, 3, "queries");
+        k = FMath::Max(k, 0);
+        TArray<int32> indices;
+        TArray<float> distances;
+        indices.Init(-1, queries.count * k);
+        distances.Init(-1.0f, queries.count * k);
+        FUEPyKernels::ParallelFor(queries.count, [&](int32 q)
+        {
+            FVector p = queries.GetVector(q);
+            TArray<TPair<float,int32>> best; // (distSq, index), kept sorted, at most k long
+            best.Reserve(k+1);
+            for (int32 i=0; i < points.count; i++)
+            {
+                float d = FVector::DistSquared(p, points.GetVector(i));
+                if (best.Num() == k && (k == 0 || d >= best.Last().Key))
+                    continue;
+                int32 at = best.Num();
+                while (at > 0 && best[at-1].Key > d)
+                    at--;
+                best.Insert(TPair<float,int32>(d, i), at);
+                if (best.Num() > k)
+                    best.Pop(false);
+            }
+            for (int32 j=0; j < best.Num(); j++)
+            {
+                indices[q*k + j] = best[j].Value;
+                distances[q*k + j] = FMath::Sqrt(best[j].Key);
+            }
+        });
+        return py::make_tuple(MakePyBuffer(indices.GetData(), queries.count, k), MakePyBuffer(distances.GetData(), queries.count, k));
+    });
+
+    // values is (N,D), weights is (Q,N). Returns a (Q,D) buffer where row q = sum over i of weights[q,i] * values[i].
+    m.def("WeightedSums", [](py::object& _values, py::object& _weights, int dim)
+    {
+        if (dim < 1)
+            throw py::value_error("dim must be >= 1");
+        FPyBufferIn<float> values(_values, dim, "values");
+        if (values.count == 0)
+            throw py::value_error("values is empty");
+        FPyBufferIn<float> weights(_weights, values.count, "weights");
+        TArray<float> out;
+        out.SetNumZeroed(weights.count * dim);
+        FUEPyKernels::ParallelFor(weights.count, [&](int32 q)
+        {
+            const float* w = weights[q];
+            float* row = out.GetData() + q * dim;
+            for (int32 i=0; i < values.count; i++)
+            {
+                if (w[i] == 0.0f)
+                    continue;
+                const float* v = values[i];
+                for (int32 d=0; d < dim; d++)
+                    row[d] += w[i] * v[d];
+            }
+        });
+        return MakePyBuffer(out.GetData(), weights.count, dim);
+    }, "values"_a, "weights"_a, "dim"_a=1);
+
+    // Classic 'seek' steering: for each agent, returns the force that turns its velocity toward its target, clamped to
+    // maxForce. positions, velocities and targets are all (N,3).
+    m.def("SeekForces", [](py::object& _positions, py::object& _velocities, py::object& _targets, float maxSpeed, float maxForce)
+    {
+        FPyBufferIn<float> positions(_positions, 3, "positions");
+        FPyBufferIn<float> velocities(_velocities, 3, "velocities");
+        FPyBufferIn<float> targets(_targets, 3, "targets");
+        if (velocities.count != positions.count || targets.count != positions.count)
+            throw py::value_error("positions, velocities and targets must all be the same length");
+        TArray<FVector> out;
+        out.SetNumUninitialized(positions.count);
+        FUEPyKernels::ParallelFor(positions.count, [&](int32 i)
+        {
+            FVector desired = (targets.GetVector(i) - positions.GetVector(i)).GetSafeNormal() * maxSpeed;
+            out[i] = (desired - velocities.GetVector(i)).GetClampedToMaxSize(maxForce);
+        });
+        return MakePyBuffer((float*)out.GetData(), out.Num(), 3);
+    }, "positions"_a, "velocities"_a, "targets"_a, "maxSpeed"_a, "maxForce"_a);
+
+    // For each agent, returns the sum of pushes away from every other agent within radius, with the push falling off
+    // linearly with distance. positions is (N,3). This is O(N^2), so for big crowds use a SpatialIndex to find neighbors.
+    m.def("SeparationForces", [](py::object& _positions, float radius, float strength)
+    {
+        FPyBufferIn<float> positions(_positions, 3, "positions");
+        float radiusSq = radius * radius;
+        TArray<FVector> out;
+        out.SetNumUninitialized(positions.count);
+        FUEPyKernels::ParallelFor(positions.count, [&](int32 i)
+        {
+            FVector p = positions.GetVector(i);
+            FVector force = FVector::ZeroVector;
+            for (int32 j=0; j < positions.count; j++)
+            {
+                if (j == i)
+                    continue;
+                FVector away = p - positions.GetVector(j);
+                float distSq = away.SizeSquared();
+                if (distSq >= radiusSq || distSq < SMALL_NUMBER)
+                    continue;
+                float dist = FMath::Sqrt(distSq);
+                force += (away / dist) * (1.0f - dist / radius);
+            }
+            out[i] = force * strength;
+        });
+        return MakePyBuffer((float*)out.GetData(), out.Num(), 3);
+    }, "positions"_a, "radius"_a, "strength"_a=1.0f);
+
+    // evaluates a float, vector, or color curve at each time in a float32 buffer. Returns a (numTimes, numChannels) buffer.
+    m.def("SampleCurve", [](UCurveBase* curve, py::object& times) { return EvaluateCurveBatch(curve, times); });
+
+    // Evaluates many curves at many times; all curves must have the same number of channels. Returns a (numCurves * numTimes,
+    // numChannels) buffer, where row c * numTimes + t is curve c at times[t].
+    m.def("EvaluateCurves", [](py::list& _curves, py::object& _times)
+    {
+        TArray<FCurveChannels> curves;
+        int32 numChannels = 0;
+        for (py::handle h : _curves)
+        {
+            FCurveChannels& channels = curves.AddDefaulted_GetRef();
+            if (!channels.Init(h.cast<UCurveBase*>()))
+                throw py::value_error("invalid or unsupported curve");
+            if (numChannels && channels.Num() != numChannels)
+                throw py::value_error("all curves must have the same number of channels");
+            numChannels = channels.Num();
+        }
+        FPyBufferIn<float> times(_times, 1, "times");
+        TArray<float> out;
+        out.SetNumUninitialized(curves.Num() * times.count * numChannels);
+        FUEPyKernels::ParallelFor(curves.Num() * times.count, [&](int32 row)
+        {
+            curves[row / times.count].Eval(times.data[row % times.count], out.GetData() + row*numChannels);
+        });
+        return MakePyBuffer(out.GetData(), curves.Num() * times.count, numChannels);
+    });
+
+    py::class_<FCurveLUT>(m, "CurveLUT")
+        .def_readonly("minTime", &FCurveLUT::minTime)
+        .def_readonly("maxTime", &FCurveLUT::maxTime)
+        .def_readonly("numSamples", &FCurveLUT::numSamples)
+        .def_readonly("numChannels", &FCurveLUT::numChannels)
+        .def_property_readonly("values", [](FCurveLUT& self) { return MakePyBuffer(self.values.GetData(), self.numSamples, self.numChannels); })
+        .def("Evaluate", [](FCurveLUT& self, float t) -> py::object
+        {   // returns a float for single-channel curves, otherwise a tuple
+            float out[4];
+            self.Eval(t, out);
+            if (self.numChannels == 1)
+                return py::float_(out[0]);
+            py::tuple ret(self.numChannels);
+            for (int32 c=0; c < self.numChannels; c++)
+                ret[c] = out[c];
+            return ret;
+        })
+        .def("EvaluateBatch", [](FCurveLUT& self, py::object& _times)
+        {
+            FPyBufferIn<float> times(_times, 1, "times");
+            TArray<float> out;
+            out.SetNumUninitialized(times.count * self.numChannels);
+            FUEPyKernels::ParallelFor(times.count, [&](int32 i) { self.Eval(times.data[i], out.GetData() + i*self.numChannels); });
+            return MakePyBuffer(out.GetData(), times.count, self.numChannels);
+        })
+        ;
+
+    // Bakes a curve into a CurveLUT with numSamples uniformly spaced samples. By default the curve's own time range is used.
+    m.def("BakeCurve", [](UCurveBase* curve, int numSamples, py::object& minTime, py::object& maxTime)
+    {
+        float start = 0.0f, end = 0.0f;
+        if (VALID(curve))
+            curve->GetTimeRange(start, end);
+        if (!minTime.is_none()) start = minTime.cast<float>();
+        if (!maxTime.is_none()) end = maxTime.cast<float>();
+        FCurveLUT* lut = new FCurveLUT();
+        try {
+            lut->Bake(curve, numSamples, start, end);
+        } catch (...) {
+            delete lut;
+            throw;
+        }
+        return lut;
+    }, "curve"_a, "numSamples"_a=256, "minTime"_a=py::none(), "maxTime"_a=py::none());
+}
+
+//#pragma optimize("", on)
+
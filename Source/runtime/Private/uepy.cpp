@@ -2,7 +2,9 @@
 
 #include "uepy.h"
 #include "common.h"
+#include "mod_uepy_batch.h"
 #include "mod_uepy_umg.h"
+#include "TickLOD.h"
 #include "Async/Async.h"
 
 #if WITH_EDITOR
@@ -121,6 +123,8 @@ void FinishPythonInit()
 #endif
 
         // initialize any builtin modules
+        _LoadModuleBatch(m);
+        _LoadModuleKernels(m);
         _LoadModuleUMG(m);
 
         // now give all other modules a chance to startup as well
@@ -481,7 +485,7 @@ void FPyObjectTracker::AddReferencedObjects(FReferenceCollector& InCollector)
 AActor_CGLUE::AActor_CGLUE() { PrimaryActorTick.bCanEverTick = true; PrimaryActorTick.bStartWithTickEnabled = false; }
 void AActor_CGLUE::BeginPlay() { try { pyInst.attr("BeginPlay")(); } catchpy; }
 void AActor_CGLUE::EndPlay(const EEndPlayReason::Type reason) { try { pyInst.attr("EndPlay")((int)reason); } catchpy; }
-void AActor_CGLUE::Tick(float dt) { if (PYOK && tickAllowed) try { pyInst.attr("Tick")(dt); } catchpy; }
+void AActor_CGLUE::Tick(float dt) { if (PYOK && tickAllowed) try { pyInst.attr("Tick")(FTickLODManager::AccumulatedDelta(this, lodLastTickTime, dt)); } catchpy; }
 void AActor_CGLUE::SuperBeginPlay() { Super::BeginPlay(); }
 void AActor_CGLUE::SuperEndPlay(EEndPlayReason::Type reason) { Super::EndPlay(reason); }
 void AActor_CGLUE::SuperTick(float dt) { Super::Tick(dt); }
@@ -491,7 +495,7 @@ void AActor_CGLUE::GatherCurrentMovement() { if (IsReplicatingMovement()) Super:
 APawn_CGLUE::APawn_CGLUE() { PrimaryActorTick.bCanEverTick = true; PrimaryActorTick.bStartWithTickEnabled = false; }
 void APawn_CGLUE::BeginPlay() { try { pyInst.attr("BeginPlay")(); } catchpy; }
 void APawn_CGLUE::EndPlay(const EEndPlayReason::Type reason) { try { pyInst.attr("EndPlay")((int)reason); } catchpy; }
-void APawn_CGLUE::Tick(float dt) { if (PYOK && tickAllowed) try { pyInst.attr("Tick")(dt); } catchpy; }
+void APawn_CGLUE::Tick(float dt) { if (PYOK && tickAllowed) try { pyInst.attr("Tick")(FTickLODManager::AccumulatedDelta(this, lodLastTickTime, dt)); } catchpy; }
 void APawn_CGLUE::SuperBeginPlay() { Super::BeginPlay(); }
 void APawn_CGLUE::SuperEndPlay(EEndPlayReason::Type reason) { Super::EndPlay(reason); }
 void APawn_CGLUE::SuperTick(float dt) { Super::Tick(dt); }
@@ -507,7 +511,7 @@ void APawn_CGLUE::UnPossessed() { Super::UnPossessed(); try { pyInst.attr("UnPos
 ACharacter_CGLUE::ACharacter_CGLUE() { PrimaryActorTick.bCanEverTick = true; PrimaryActorTick.bStartWithTickEnabled = false; }
 void ACharacter_CGLUE::BeginPlay() { try { pyInst.attr("BeginPlay")(); } catchpy; }
 void ACharacter_CGLUE::EndPlay(const EEndPlayReason::Type reason) { try { pyInst.attr("EndPlay")((int)reason); } catchpy; }
-void ACharacter_CGLUE::Tick(float dt) { if (PYOK && tickAllowed) try { pyInst.attr("Tick")(dt); } catchpy; }
+void ACharacter_CGLUE::Tick(float dt) { if (PYOK && tickAllowed) try { pyInst.attr("Tick")(FTickLODManager::AccumulatedDelta(this, lodLastTickTime, dt)); } catchpy; }
 void ACharacter_CGLUE::SuperBeginPlay() { Super::BeginPlay(); }
 void ACharacter_CGLUE::SuperEndPlay(EEndPlayReason::Type reason) { Super::EndPlay(reason); }
 void ACharacter_CGLUE::SuperTick(float dt) { Super::Tick(dt); }
@@ -545,68 +549,93 @@ std::string debugObj(py::object *o)
     return s;
 }
 
-UClass *PyObjectToUClass(py::object& klassThing)
-{   
-    // TODO: the logic in here is super fragile
+// Cache of Python type --> UClass for PyObjectToUClass, since most callers pass the same handful of classes over and over.
+// Each entry holds a ref to its type so that the type's address can't get reused by some other type while it's in here.
+// Cleared whenever a Python subclass is (re)registered, e.g. on a hot reload.
+struct FUClassCacheEntry
+{
+    py::object type;
+    TWeakObjectPtr<UClass> klass;
+};
+static TMap<PyObject*, FUClassCacheEntry> uclassCache;
+static int64 uclassCacheHits = 0;
+static int64 uclassCacheMisses = 0;
+
+void InvalidateUClassCache()
+{
+    uclassCache.Reset();
+}
 
-    if (klassThing.is_none())
-    {
-        LERROR("Cannot cast None to UClass");
-        return nullptr;
-    }
+void GetUClassCacheStats(int64& hits, int64& misses, int32& size)
+{
+    hits = uclassCacheHits;
+    misses = uclassCacheMisses;
+    size = uclassCache.Num();
+}
+
+static UClass* _PyObjectToUClass(py::object& klassThing)
+{
     // see if it's a registered subclass of a glue class
     if (py::hasattr(klassThing, "engineClass"))
-    {
-        UClass* klass = klassThing.attr("engineClass").cast<UClass*>();
-        //LOG("XXXA %s --> %s", UTF8_TO_TCHAR(py::repr(klassThing).cast<std::string>().c_str()), *klass->GetName());
-        return klass;
-    }
+        return klassThing.attr("engineClass").cast<UClass*>();
 
     // see if it's a glue class
     if (py::hasattr(klassThing, "cppGlueClass"))
-    {
-        UClass *klass = klassThing.attr("cppGlueClass").attr("StaticClass")().cast<UClass*>()->GetSuperClass();
-        //LOG("XXXB %s --> %s", UTF8_TO_TCHAR(py::repr(klassThing).cast<std::string>().c_str()), *klass->GetName());
-        return klass;
-    }
+        return klassThing.attr("cppGlueClass").attr("StaticClass")().cast<UClass*>()->GetSuperClass();
 
-    try {
+    if (py::isinstance<UObject>(klassThing))
+    {
         UObject *uobj = klassThing.cast<UObject*>();
+        if (!uobj)
+            return nullptr;
         if (UClass *klass = Cast<UClass>(uobj))
-        {
-            //LOG("XXXD %s --> %s", UTF8_TO_TCHAR(py::repr(klassThing).cast<std::string>().c_str()), *klass->GetName());
             return klass; // caller already called StaticClass on it
-        }
-
         return uobj->GetClass();
-    } catch (std::exception e)
+    }
+
+    // maybe it's a pybind11-exposed class?
+    if (py::hasattr(klassThing, "StaticClass"))
+        return klassThing.attr("StaticClass")().cast<UClass*>();
+
+    return nullptr;
+}
+
+UClass *PyObjectToUClass(py::object& klassThing)
+{   
+    if (klassThing.is_none())
+    {
+        LERROR("Cannot cast None to UClass");
+        return nullptr;
+    }
+
+    bool isType = PyType_Check(klassThing.ptr());
+    if (isType)
     {
-        // maybe it's a pybind11-exposed class?
-        if (py::hasattr(klassThing, "StaticClass"))
+        FUClassCacheEntry* entry = uclassCache.Find(klassThing.ptr());
+        UClass* klass = entry ? entry->klass.Get() : nullptr;
+        if (klass)
         {
-            UClass* klass = klassThing.attr("StaticClass")().cast<UClass*>();
-            //LOG("XXXC %s --> %s", UTF8_TO_TCHAR(py::repr(klassThing).cast<std::string>().c_str()), *klass->GetName());
+            uclassCacheHits++;
             return klass;
         }
+        uclassCacheMisses++;
+    }
 
+    UClass* klass = _PyObjectToUClass(klassThing);
+    if (!klass)
+    {
         std::string s = py::repr(klassThing);
-        LERROR("XXXE Failed to convert %s to UClass", UTF8_TO_TCHAR(s.c_str()));
+        LERROR("Failed to convert %s to UClass", UTF8_TO_TCHAR(s.c_str()));
         return nullptr;
     }
 
-    /*
-    // see if it'll cast to a UClass directly (i.e. caller already called StaticClass)
-    try {
-        return klassThing.cast<UClass*>();
-    }
-    catch (std::exception e) // this logs a "pybind11::cast_error at memory location" error even though we are catching it
+    if (isType)
     {
-        // maybe it's a pybind11-exposed class?
-        if (py::hasattr(klassThing, "StaticClass"))
-            return klassThing.attr("StaticClass")().cast<UClass*>();
-        return nullptr;
+        FUClassCacheEntry& entry = uclassCache.FindOrAdd(klassThing.ptr());
+        entry.type = klassThing;
+        entry.klass = klass;
     }
-    */
+    return klass;
 }
 
 bool _setuprop(FProperty *prop, uint8* buffer, py::object& value, int index)
@@ -627,8 +656,7 @@ bool _setuprop(FProperty *prop, uint8* buffer, py::object& value, int index)
             iu64prop->SetPropertyValue_InContainer(buffer, value.cast<uint64>(), index);
         else if (auto strprop = CastField<FStrProperty>(prop))
         {
-            std::string t = value.cast<std::string>();
-            strprop->SetPropertyValue_InContainer(buffer, FSTR(t), index);
+            strprop->SetPropertyValue_InContainer(buffer, value.cast<FString>(), index);
         }
         else if (auto textprop = CastField<FTextProperty>(prop))
         {
@@ -723,9 +751,7 @@ py::object _getprop(FProperty *prop, uint8* buffer, int index)
     _GETPROP(FObjectProperty, UObject*);
     if (auto strprop = CastField<FStrProperty>(prop))
     {
-        FString sret = strprop->GetPropertyValue_InContainer(buffer, index);
-        std::string ret = TCHAR_TO_UTF8(*sret);
-        return py::cast(ret);
+        return py::cast(strprop->GetPropertyValue_InContainer(buffer, index));
     }
     if (auto textprop = CastField<FTextProperty>(prop))
     {
@@ -0,0 +1,122 @@
+#include "uepy_strings.h"
+#include "uepy.h"
+
+bool PyUnicodeToFString(PyObject* s, FString& out)
+{
+    if (!PyUnicode_Check(s) || PyUnicode_READY(s) != 0)
+    {
+        PyErr_Clear();
+        return false;
+    }
+
+    Py_ssize_t len = PyUnicode_GET_LENGTH(s);
+    TArray<TCHAR>& chars = out.GetCharArray();
+    if (len == 0)
+    {
+        chars.Reset();
+        return true;
+    }
+
+    int kind = PyUnicode_KIND(s);
+    void* data = PyUnicode_DATA(s);
+    if (kind == PyUnicode_1BYTE_KIND)
+    {
+        const Py_UCS1* src = (const Py_UCS1*)data;
+        chars.SetNumUninitialized(len + 1);
+        for (Py_ssize_t i=0; i < len; i++)
+            chars[i] = (TCHAR)src[i];
+    }
+    else if (kind == PyUnicode_2BYTE_KIND)
+    {
+        chars.SetNumUninitialized(len + 1);
+        FMemory::Memcpy(chars.GetData(), data, len * sizeof(TCHAR));
+    }
+    else
+    {   // characters outside the BMP become surrogate pairs
+        const Py_UCS4* src = (const Py_UCS4*)data;
+        Py_ssize_t numOut = len;
+        for (Py_ssize_t i=0; i < len; i++)
+            if (src[i] > 0xFFFF)
+                numOut++;
+        chars.SetNumUninitialized(numOut + 1);
+        TCHAR* dest = chars.GetData();
+        for (Py_ssize_t i=0; i < len; i++)
+        {
+            Py_UCS4 c = src[i];
+            if (c > 0xFFFF)
+            {
+                c -= 0x10000;
+                *dest++ = (TCHAR)(0xD800 + (c >> 10));
+                *dest++ = (TCHAR)(0xDC00 + (c & 0x3FF));
+            }
+            else
+                *dest++ = (TCHAR)c;
+        }
+    }
+    chars.Last() = 0;
+    return true;
+}
+
+PyObject* FStringToPyUnicode(const FString& s)
+{
+    int32 len = s.Len();
+    if (len == 0)
+        return PyUnicode_New(0, 0);
+
+    // FromKindAndData picks the most compact storage, but it takes UCS-2 at face value, so strings with surrogate pairs
+    // need to be decoded as UTF-16 instead
+    const TCHAR* data = *s;
+    for (int32 i=0; i < len; i++)
+    {
+        if (data[i] >= 0xD800 && data[i] <= 0xDFFF)
+        {
+            int byteOrder = PLATFORM_LITTLE_ENDIAN ? -1 : 1;
+            return PyUnicode_DecodeUTF16((const char*)data, len * sizeof(TCHAR), "surrogatepass", &byteOrder);
+        }
+    }
+    return PyUnicode_FromKindAndData(PyUnicode_2BYTE_KIND, data, len);
+}
+
+static TMap<PyObject*, TPair<py::object, FName>> fnameCache; // interned str --> (ref to that str, FName)
+static int64 fnameCacheHits = 0;
+static int64 fnameCacheMisses = 0;
+static const int32 FNAME_CACHE_MAX = 8192; // cleared if it gets this big, so dynamically built names can't grow it forever
+
+bool PyUnicodeToFName(PyObject* s, FName& out)
+{
+    if (!PyUnicode_Check(s))
+        return false;
+
+    bool interned = PyUnicode_CHECK_INTERNED(s) != 0;
+    if (interned)
+    {
+        TPair<py::object, FName>* entry = fnameCache.Find(s);
+        if (entry)
+        {
+            fnameCacheHits++;
+            out = entry->Value;
+            return true;
+        }
+        fnameCacheMisses++;
+    }
+
+    FString str;
+    if (!PyUnicodeToFString(s, str))
+        return false;
+    out = FName(*str);
+
+    if (interned)
+    {
+        if (fnameCache.Num() >= FNAME_CACHE_MAX)
+            fnameCache.Reset();
+        fnameCache.Add(s, TPair<py::object, FName>(py::reinterpret_borrow<py::object>(s), out));
+    }
+    return true;
+}
+
+void GetFNameCacheStats(int64& hits, int64& misses, int32& size)
+{
+    hits = fnameCacheHits;
+    misses = fnameCacheMisses;
+    size = fnameCache.Num();
+}
@@ -0,0 +1,58 @@
+#include "uepy_valuetypes.h"
+
+static const SIZE_T SLAB_BYTES = 64 * 1024;
+static const SIZE_T SLOT_BYTES = 16;
+
+struct FFreeSlot
+{
+    FFreeSlot* next;
+};
+
+// only touched with the GIL held, since these objects are only created and destroyed from Python
+static FFreeSlot* freeList = nullptr;
+static TSet<UPTRINT> slabs; // base addresses
+static bool poolEnabled = true;
+static FPyValuePoolStats stats;
+
+void* PyValuePoolAlloc()
+{
+    if (!freeList)
+    {   // carve a new slab into slots
+        uint8* slab = (uint8*)FMemory::Malloc(SLAB_BYTES, SLAB_BYTES);
+        slabs.Add((UPTRINT)slab);
+        stats.numSlabs++;
+        for (SIZE_T offset = SLAB_BYTES; offset >= SLOT_BYTES; offset -= SLOT_BYTES)
+        {
+            FFreeSlot* slot = (FFreeSlot*)(slab + offset - SLOT_BYTES);
+            slot->next = freeList;
+            freeList = slot;
+        }
+    }
+    FFreeSlot* slot = freeList;
+    freeList = slot->next;
+    stats.numInUse++;
+    stats.numAllocs++;
+    return slot;
+}
+
+bool PyValuePoolFree(void* p)
+{
+    if (!p || stats.numInUse == 0 || !slabs.Contains((UPTRINT)p & ~(UPTRINT)(SLAB_BYTES - 1)))
+        return false;
+    FFreeSlot* slot = (FFreeSlot*)p;
+    slot->next = freeList;
+    freeList = slot;
+    stats.numInUse--;
+    return true;
+}
+
+bool PyValuePoolEnabled() { return poolEnabled; }
+void SetPyValuePoolEnabled(bool enabled) { poolEnabled = enabled; }
+void _PyValuePoolFallback() { stats.numFallbacks++; }
+FPyValuePoolStats GetPyValuePoolStats() { return stats; }
+
+void ResetPyValuePoolStats()
+{
+    stats.numAllocs = 0;
+    stats.numFallbacks = 0;
+}
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 #include "incpybind.h"
+#include "uepy_strings.h"
+#include "uepy_valuetypes.h"
 #include "IUEPYGlueMixin.h"
 #include "Runtime/CoreUObject/Public/UObject/GCObject.h"
 #include <functional>
@@ -54,10 +56,10 @@
 .def_property(#propName, [](className& self) { return (bool)self.propName; }, [](className& self, bool v) { self.propName = v; })
 
 #define STR_PROP(propName, className)\
-.def_property(#propName, [](className& self) { std::string s = TCHAR_TO_UTF8(*self.propName); return s; }, [](className& self, std::string& v) { self.propName = FSTR(v); })
+.def_property(#propName, [](className& self) { return self.propName; }, [](className& self, FString& v) { self.propName = v; })
 
 #define FNAME_PROP(propName, className)\
-.def_property(#propName, [](className& self) { std::string s = TCHAR_TO_UTF8(*self.propName.ToString()); return s; }, [](className& self, std::string& v) { self.propName = FSTR(v); })
+.def_property(#propName, [](className& self) { return self.propName; }, [](className& self, FName& v) { self.propName = v; })
 
 #define ENUM_PROP(propName, propType, className)\
 .def_property(#propName, [](className& self) { return (int)self.propName; }, [](className& self, int v) { self.propName = (propType)v; })
@@ -263,6 +265,7 @@ class UEPY_API AActor_CGLUE : public AActor, public IUEPYGlueMixin
 
 public:
     bool tickAllowed = true;
+    double lodLastTickTime = -1.0; // world time of the last Tick while registered with FTickLODManager, else < 0
     void SuperBeginPlay();
     void SuperEndPlay(EEndPlayReason::Type reason);
     void SuperPostInitializeComponents() { Super::PostInitializeComponents(); }
@@ -285,6 +288,7 @@ class UEPY_API APawn_CGLUE : public APawn, public IUEPYGlueMixin
 
 public:
     bool tickAllowed = true;
+    double lodLastTickTime = -1.0; // world time of the last Tick while registered with FTickLODManager, else < 0
     void SuperBeginPlay();
     void SuperEndPlay(EEndPlayReason::Type reason);
     void SuperPostInitializeComponents() { Super::PostInitializeComponents(); }
@@ -313,6 +317,7 @@ class UEPY_API ACharacter_CGLUE : public ACharacter, public IUEPYGlueMixin
 
 public:
     bool tickAllowed = true;
+    double lodLastTickTime = -1.0; // world time of the last Tick while registered with FTickLODManager, else < 0
     void SuperBeginPlay();
     void SuperEndPlay(EEndPlayReason::Type reason);
     void SuperPostInitializeComponents() { Super::PostInitializeComponents(); }
@@ -422,10 +427,13 @@ public:
 // a UClass pointer, a C++ class that has been exposed via pybind11, or a Python class object that is a subclass
 // of a glue class. In all cases, it finds the appropriate UClass object and returns it.
 UEPY_API UClass *PyObjectToUClass(py::object& klassThing);
+UEPY_API void InvalidateUClassCache(); // call when Python classes get (re)registered
+void GetUClassCacheStats(int64& hits, int64& misses, int32& size);
 
 // stuff for integrating into the UE4 reflection system (e.g. calling BPs)
 py::object GetObjectProperty(UObject *obj, std::string k);
 void SetObjectProperty(UObject *obj, std::string k, py::object& value);
+bool _setuprop(FProperty *prop, uint8* buffer, py::object& value, int index); // sets a property on a struct/object buffer
 py::object CallObjectUFunction(UObject *obj, std::string funcName, py::tuple& args);
 void BindDelegateCallback(UObject *obj, std::string eventName, py::object& callback);
 void UnbindDelegateCallback(UObject *obj, std::string eventName, py::object& callback);
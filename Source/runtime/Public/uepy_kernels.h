@@ -0,0 +1,92 @@
+// Batch kernels: native functions that operate on whole buffers of data at once, spread across cores via ParallelFor with
+// the GIL released. Bulk data comes in via anything that supports the buffer protocol (array.array, bytearray, memoryview,
+// numpy arrays) and goes back out as memoryviews, so e.g. numpy.frombuffer can wrap results without copying them again.
+//
+// The builtin kernels live in the uepy.kernels module. Game modules can add their own from a FUEPyDelegates::LaunchInit
+// handler, e.g.:
+//
+//   FUEPyDelegates::LaunchInit.AddLambda([](py::module& uepy)
+//   {
+//       FUEPyKernels::Module().def("MyKernel", [](py::object& _points) { FPyBufferIn<float> points(_points, 3, "points"); ... });
+//   });
+
+#pragma once
+#include "incpybind.h"
+#include "CoreMinimal.h"
+#include <type_traits>
+
+// true if a Python buffer's format string is compatible with T. For integer types we only check the size and kind,
+// because e.g. numpy reports int32 as 'l' on Windows but 'i' elsewhere.
+template<typename T>
+bool _BufferFormatMatches(const py::buffer_info& info)
+{
+    if (info.itemsize != sizeof(T) || info.format.empty())
+        return false;
+    if (info.format == py::format_descriptor<T>::format())
+        return true;
+    if (std::is_integral<T>::value)
+    {
+        char code = info.format.back(); // skip any byte order prefix
+        bool isSigned = code == 'b' || code == 'h' || code == 'i' || code == 'l' || code == 'q';
+        bool isUnsigned = code == 'B' || code == 'H' || code == 'I' || code == 'L' || code == 'Q' || code == '?';
+        return std::is_signed<T>::value ? isSigned : isUnsigned;
+    }
+    return false;
+}
+
+// read-only view of a flat, C-contiguous Python buffer of T values, grouped into elements of 'stride' values each (e.g.
+// stride=3 for a buffer of vectors). Throws a Python TypeError/ValueError if the buffer isn't usable.
+template<typename T>
+struct FPyBufferIn
+{
+    py::buffer_info info;
+    const T* data = nullptr;
+    int32 count = 0; // number of elements, i.e. the number of values / stride
+    int32 stride = 1;
+
+    FPyBufferIn(const py::object& obj, int32 _stride, const char* what) : stride(_stride)
+    {
+        if (!py::isinstance<py::buffer>(obj))
+            throw py::type_error(std::string(what) + " must support the buffer protocol");
+        info = py::reinterpret_borrow<py::buffer>(obj).request();
+        if (!_BufferFormatMatches<T>(info))
+            throw py::type_error(std::string(what) + " has the wrong element type (expected format '" + py::format_descriptor<T>::format() + "', got '" + info.format + "')");
+
+        // must be C-contiguous so we can walk it as a flat array
+        py::ssize_t expected = info.itemsize;
+        for (int i=info.ndim-1; i >= 0; i--)
+        {
+            if (info.shape[i] > 1 && info.strides[i] != expected)
+                throw py::value_error(std::string(what) + " must be C-contiguous");
+            expected *= info.shape[i];
+        }
+        if (info.size % stride)
+            throw py::value_error(std::string(what) + " length must be a multiple of " + std::to_string(stride));
+        data = (const T*)info.ptr;
+        count = (int32)(info.size / stride);
+    }
+
+    const T* operator[](int32 i) const { return data + i*stride; }
+    FVector GetVector(int32 i) const { const T* p = data + i*stride; return FVector(p[0], p[1], p[2]); }
+};
+
+UEPY_API py::object _MakePyBuffer(const void* data, int32 itemSize, const std::string& format, int32 count, int32 cols);
+
+// copies count*cols values into a new Python buffer (a memoryview) shaped (count, cols), or (count,) if cols is omitted.
+// Either can be 0, in which case you get an empty buffer of that shape.
+template<typename T>
+py::object MakePyBuffer(const T* data, int32 count, int32 cols=-1)
+{
+    return _MakePyBuffer(data, sizeof(T), py::format_descriptor<T>::format(), count, cols);
+}
+
+struct UEPY_API FUEPyKernels
+{
+    // the uepy.kernels module, for registering additional kernels
+    static py::module& Module();
+
+    // calls body(i) for each i in [0, count) across worker threads, with the GIL released. body must not touch Python
+    // or UObjects.
+    static void ParallelFor(int32 count, TFunctionRef<void(int32)> body);
+};
+
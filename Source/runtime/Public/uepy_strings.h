@@ -0,0 +1,55 @@
+// pybind11 type casters for FString and FName, so bindings can take and return them directly instead of going through
+// std::string (and UTF-8) via FSTR/PYSTR. FStrings are converted straight between TCHARs and Python's own string storage:
+// Latin-1 and UCS-2 strings (i.e. nearly all of them) are just widened or copied, and only strings with characters outside
+// the BMP need surrogate pairs built.
+//
+// Converting a str to an FName means hashing it into the name table, so FName args also go through a small cache keyed by
+// str object identity. Only interned strs are cached (string literals and identifiers in Python code are interned by the
+// compiler, which covers the common case of the same tag or parameter name being passed in over and over), and the cache
+// keeps a ref to each str so that its address can't be reused by a different one.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "incpybind.h"
+
+static_assert(sizeof(TCHAR) == 2, "the FString converters assume UTF-16 TCHARs");
+
+UEPY_API bool PyUnicodeToFString(PyObject* s, FString& out); // false (with no Python error set) if s isn't a str
+UEPY_API PyObject* FStringToPyUnicode(const FString& s); // new ref
+UEPY_API bool PyUnicodeToFName(PyObject* s, FName& out);
+void GetFNameCacheStats(int64& hits, int64& misses, int32& size);
+
+namespace pybind11 { namespace detail {
+
+template <> struct type_caster<FString>
+{
+    PYBIND11_TYPE_CASTER(FString, _("str"));
+
+    bool load(handle src, bool)
+    {
+        return src && PyUnicodeToFString(src.ptr(), value);
+    }
+
+    static handle cast(const FString& src, return_value_policy, handle)
+    {
+        return FStringToPyUnicode(src);
+    }
+};
+
+template <> struct type_caster<FName>
+{
+    PYBIND11_TYPE_CASTER(FName, _("str"));
+
+    bool load(handle src, bool)
+    {
+        return src && PyUnicodeToFName(src.ptr(), value);
+    }
+
+    static handle cast(const FName& src, return_value_policy, handle)
+    {
+        return FStringToPyUnicode(src.ToString());
+    }
+};
+
+}} // namespace pybind11::detail
@@ -0,0 +1,92 @@
+// Fast path for handing small engine value types (FVector, FVector2D, FRotator, FQuat, FLinearColor, FColor) to Python.
+// Math-heavy Python code creates huge numbers of these, and pybind11's generic cast does a fair bit of work for each one:
+// a type_info lookup by typeid, a search of the registered instances for the source address (pointless for a temporary),
+// and a heap allocation for the C++ value.
+//
+// For returns by value (i.e. casts of rvalues, which are always fresh temporaries), the casters below instead use a cached
+// type_info and skip the registered instance search, and the C++ value goes in a slot from a free list of fixed-size,
+// 16-byte aligned slots carved out of 64KB slabs, which never go back to the OS. Everything else (returned references,
+// def_readwrite members, etc.) takes the generic path, so returning a reference to an object Python already has still
+// gives back that same Python object. The holder for these classes is a unique_ptr with FPyValueDeleter, which gives
+// pooled slots back to the free list and deletes anything else (e.g. values created by py::init) normally.
+//
+// The pool lives in the uepy module, so values created by other modules' casts are freed back to the same pool.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "incpybind.h"
+
+UEPY_API void* PyValuePoolAlloc(); // returns a 16 byte, 16-byte aligned slot
+UEPY_API bool PyValuePoolFree(void* p); // false if p didn't come from the pool
+UEPY_API bool PyValuePoolEnabled();
+UEPY_API void SetPyValuePoolEnabled(bool enabled); // when false, the casters below just use the generic pybind11 path (and
+                                                    // once no pooled values are alive, FPyValueDeleter is a plain delete)
+
+struct FPyValuePoolStats
+{
+    int32 numSlabs = 0;
+    int64 numInUse = 0;
+    int64 numAllocs = 0; // pooled allocations since the last reset
+    int64 numFallbacks = 0; // casts that took the generic path because the pool was disabled
+};
+UEPY_API FPyValuePoolStats GetPyValuePoolStats();
+UEPY_API void ResetPyValuePoolStats();
+UEPY_API void _PyValuePoolFallback();
+
+template <typename T>
+struct FPyValueDeleter
+{
+    void operator()(T* p) const
+    {
+        if (!PyValuePoolFree(p)) // pooled types are trivially destructible, so there's nothing else to do for those
+            delete p;
+    }
+};
+
+namespace pybind11 { namespace detail {
+
+template <typename T>
+class pooled_value_caster : public type_caster_base<T>
+{
+    static_assert(sizeof(T) <= 16 && alignof(T) <= 16 && std::is_trivially_destructible<T>::value, "doesn't fit in a pool slot");
+
+    static handle cast_value(const T& src)
+    {
+        static const type_info* tinfo = nullptr;
+        if (!tinfo)
+            tinfo = get_type_info(typeid(T));
+        if (!tinfo || !PyValuePoolEnabled())
+        {
+            _PyValuePoolFallback();
+            return type_caster_base<T>::cast(&src, return_value_policy::copy, handle());
+        }
+
+        PyObject* inst = make_new_instance(tinfo->type);
+        instance* wrapper = reinterpret_cast<instance*>(inst);
+        values_and_holders(wrapper).begin()->value_ptr() = new (PyValuePoolAlloc()) T(src);
+        wrapper->owned = true;
+        tinfo->init_instance(wrapper, nullptr); // registers the instance and constructs the holder
+        return inst;
+    }
+
+public:
+    using type_caster_base<T>::cast;
+
+    static handle cast(T&& src, return_value_policy, handle)
+    {
+        return cast_value(src);
+    }
+};
+
+template <> class type_caster<FVector> : public pooled_value_caster<FVector> {};
+template <> class type_caster<FVector2D> : public pooled_value_caster<FVector2D> {};
+template <> class type_caster<FRotator> : public pooled_value_caster<FRotator> {};
+template <> class type_caster<FQuat> : public pooled_value_caster<FQuat> {};
+template <> class type_caster<FLinearColor> : public pooled_value_caster<FLinearColor> {};
+template <> class type_caster<FColor> : public pooled_value_caster<FColor> {};
+
+}} // namespace pybind11::detail
+
+// holder types for the py::class_ declarations of the above
+template <typename T> using TPyValueHolder = std::unique_ptr<T, FPyValueDeleter<T>>;